@@ -0,0 +1,529 @@
+#include "link_test.h"
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#endif
+
+#if !defined(ESP_PLATFORM) || CONFIG_WIFI_MANAGER_LINK_TEST
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef ESP_PLATFORM
+#include "lwip/sockets.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <sys/param.h>
+#define LINK_TEST_BUF_SIZE      CONFIG_WIFI_MANAGER_LINK_TEST_BUF_SIZE
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <time.h>
+#define LINK_TEST_BUF_SIZE      2920
+#endif
+
+#define LINK_TEST_POLL_MS       100     // Socket timeout to check the deadline and stop requests
+#define LINK_TEST_UDP_HDR_LEN   12      // iperf2 datagram header: int32 id, uint32 sec, uint32 usec
+#define LINK_TEST_UDP_FIN_COUNT 10      // Negative-id datagrams sent to end a UDP source run
+#define LINK_TEST_YIELD_MS      50      // Max. time the UDP source runs without giving up the CPU
+
+// Single preallocated buffer for all modes; only one test runs at a time
+static uint8_t link_test_buf[LINK_TEST_BUF_SIZE];
+static volatile bool link_test_stop_requested = false;
+
+static const char *const mode_names[LINK_TEST_MODE_COUNT] = {
+    [LINK_TEST_TCP_RX] = "tcp_rx",
+    [LINK_TEST_TCP_TX] = "tcp_tx",
+    [LINK_TEST_UDP_RX] = "udp_rx",
+    [LINK_TEST_UDP_TX] = "udp_tx",
+    [LINK_TEST_ECHO]   = "echo",
+};
+
+link_test_mode_t link_test_mode_from_name(const char *name) {
+    for (int i = 0; i < LINK_TEST_MODE_COUNT; i++) {
+        if (strcmp(name, mode_names[i]) == 0) return (link_test_mode_t)i;
+    }
+    return LINK_TEST_MODE_COUNT;
+}
+
+const char *link_test_mode_name(link_test_mode_t mode) {
+    return mode < LINK_TEST_MODE_COUNT ? mode_names[mode] : "unknown";
+}
+
+void link_test_stop(void) {
+    link_test_stop_requested = true;
+}
+
+/**
+ * @brief Monotonic time in microseconds.
+ */
+static int64_t link_test_now_us(void) {
+#ifdef ESP_PLATFORM
+    return esp_timer_get_time();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+/**
+ * @brief Gives up the CPU. On the device this lets IDLE (and its task watchdog) run; short
+ * usleep() pacing and failing non-blocking sends never block the task.
+ */
+static void link_test_yield(void) {
+#ifdef ESP_PLATFORM
+    vTaskDelay(1);
+#else
+    sched_yield();
+#endif
+}
+
+/**
+ * @brief Sets receive and send timeouts so blocking calls return to check the deadline.
+ */
+static void link_test_set_timeouts(int sock) {
+    struct timeval tv = { .tv_sec = 0, .tv_usec = LINK_TEST_POLL_MS * 1000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static bool link_test_timeout_errno(int err) {
+    return err == EAGAIN || err == EWOULDBLOCK || err == EINTR;
+}
+
+/**
+ * @brief Creates a socket bound to the port on all interfaces (sinks and echo).
+ */
+static int link_test_bind(int type, uint16_t port) {
+    int sock = socket(AF_INET, type, 0);
+    if (sock < 0) return -1;
+
+    int one = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_ANY) };
+    if (bind(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0 || (type == SOCK_STREAM && listen(sock, 1) != 0)) {
+        int err = errno;
+        close(sock);
+        errno = err;
+        return -1;
+    }
+    link_test_set_timeouts(sock);
+    return sock;
+}
+
+/**
+ * @brief Creates a socket connected to the peer (sources).
+ */
+static int link_test_connect(int type, const char *host, uint16_t port) {
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int sock = socket(AF_INET, type, 0);
+    if (sock < 0) return -1;
+    if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int err = errno;
+        close(sock);
+        errno = err;
+        return -1;
+    }
+    link_test_set_timeouts(sock);
+    return sock;
+}
+
+static int link_test_tcp_rx(const link_test_config_t *cfg, link_test_result_t *res) {
+    int lsock = link_test_bind(SOCK_STREAM, cfg->port);
+    if (lsock < 0) return errno;
+
+    // Wait up to the test duration for the peer
+    int64_t deadline = link_test_now_us() + (int64_t)cfg->duration_ms * 1000;
+    int sock = -1;
+    while (sock < 0 && !link_test_stop_requested && link_test_now_us() < deadline) {
+        sock = accept(lsock, NULL, NULL);
+        if (sock < 0 && !link_test_timeout_errno(errno)) break;
+    }
+    int err = errno;
+    close(lsock);
+    if (sock < 0) return link_test_stop_requested || link_test_timeout_errno(err) ? ETIMEDOUT : err;
+    link_test_set_timeouts(sock);
+
+    int64_t first = 0, last = 0;
+    int ret = 0;
+    while (!link_test_stop_requested) {
+        int n = recv(sock, link_test_buf, sizeof(link_test_buf), 0);
+        int64_t now = link_test_now_us();
+        if (n > 0) {
+            if (!first) {
+                first = now;
+                deadline = now + (int64_t)cfg->duration_ms * 1000;
+            }
+            last = now;
+            res->bytes += n;
+        } else if (n == 0) {
+            break;
+        } else if (!link_test_timeout_errno(errno)) {
+            ret = errno;
+            break;
+        }
+        // Before the first byte the deadline set for accept() still applies, so an idle peer cannot hold the sink
+        if (now >= deadline) break;
+    }
+    close(sock);
+    res->elapsed_ms = (uint32_t)((last - first) / 1000);
+    return ret;
+}
+
+static int link_test_tcp_tx(const link_test_config_t *cfg, link_test_result_t *res) {
+    int sock = link_test_connect(SOCK_STREAM, cfg->host, cfg->port);
+    if (sock < 0) return errno;
+
+    for (size_t i = 0; i < sizeof(link_test_buf); i++) {
+        link_test_buf[i] = (uint8_t)('0' + i % 10);
+    }
+
+    int64_t start = link_test_now_us();
+    int64_t deadline = start + (int64_t)cfg->duration_ms * 1000;
+    int ret = 0;
+    while (!link_test_stop_requested && link_test_now_us() < deadline) {
+        int n = send(sock, link_test_buf, sizeof(link_test_buf), 0);
+        if (n > 0) {
+            res->bytes += n;
+        } else if (n < 0 && !link_test_timeout_errno(errno)) {
+            ret = errno;
+            break;
+        }
+    }
+    res->elapsed_ms = (uint32_t)((link_test_now_us() - start) / 1000);
+    close(sock);
+    return ret;
+}
+
+static int link_test_udp_rx(const link_test_config_t *cfg, link_test_result_t *res) {
+    int sock = link_test_bind(SOCK_DGRAM, cfg->port);
+    if (sock < 0) return errno;
+
+    int64_t deadline = link_test_now_us() + (int64_t)cfg->duration_ms * 1000;
+    int64_t first = 0, last = 0, prev_transit = 0, jitter = 0;   // jitter is scaled by 16 (RFC 3550 A.8)
+    int32_t highest = -1;       // Sequence numbers start at 0, so datagrams lost before the first one count
+    int ret = 0;
+    while (!link_test_stop_requested) {
+        int n = recv(sock, link_test_buf, sizeof(link_test_buf), 0);
+        int64_t now = link_test_now_us();
+        if (n >= LINK_TEST_UDP_HDR_LEN) {
+            uint32_t hdr[3];
+            memcpy(hdr, link_test_buf, sizeof(hdr));
+            int32_t seq = (int32_t)ntohl(hdr[0]);
+            if (seq < 0) break;     // Sender finished
+            int64_t transit = now - ((int64_t)ntohl(hdr[1]) * 1000000 + ntohl(hdr[2]));
+
+            if (!first) {
+                first = now;
+                deadline = now + (int64_t)cfg->duration_ms * 1000;
+            } else {
+                int64_t d = transit - prev_transit;
+                jitter += (d < 0 ? -d : d) - ((jitter + 8) >> 4);
+            }
+            if (seq > highest) {
+                res->lost += seq - highest - 1;
+                highest = seq;
+            } else if (seq < highest) {
+                res->out_of_order++;
+                if (res->lost) res->lost--;
+            }   // seq == highest: duplicate, neither lost nor late
+            prev_transit = transit;
+            last = now;
+            res->packets++;
+            res->bytes += n;
+        } else if (n < 0 && !link_test_timeout_errno(errno)) {
+            ret = errno;
+            break;
+        }
+        if (now >= deadline) break;
+    }
+    close(sock);
+    res->elapsed_ms = (uint32_t)((last - first) / 1000);
+    res->jitter_us = (uint32_t)(jitter >> 4);
+    return ret;
+}
+
+static int link_test_udp_tx(const link_test_config_t *cfg, link_test_result_t *res) {
+    int sock = link_test_connect(SOCK_DGRAM, cfg->host, cfg->port);
+    if (sock < 0) return errno;
+
+    size_t len = cfg->len;
+    if (len < LINK_TEST_UDP_HDR_LEN) len = LINK_TEST_UDP_HDR_LEN;
+    if (len > sizeof(link_test_buf)) len = sizeof(link_test_buf);
+    memset(link_test_buf, 0, len);
+
+    // Pace datagrams to the target rate; 0 sends as fast as possible
+    int64_t interval_us = cfg->rate_kbps ? (int64_t)len * 8000 / cfg->rate_kbps : 0;
+    int64_t start = link_test_now_us();
+    int64_t deadline = start + (int64_t)cfg->duration_ms * 1000;
+    int64_t next = start;
+    int64_t last_yield = start;
+    int64_t yielded_us = 0;
+    int32_t seq = 0;
+    int ret = 0;
+    while (!link_test_stop_requested) {
+        int64_t now = link_test_now_us();
+        if (now >= deadline) break;
+        if (now - last_yield >= LINK_TEST_YIELD_MS * 1000) {
+            link_test_yield();
+            last_yield = link_test_now_us();
+            yielded_us += last_yield - now;
+            now = last_yield;
+        }
+        if (now < next) {
+            usleep((useconds_t)(next - now));
+            now = link_test_now_us();
+        }
+        next += interval_us;
+
+        uint32_t hdr[3] = { htonl((uint32_t)seq), htonl((uint32_t)(now / 1000000)), htonl((uint32_t)(now % 1000000)) };
+        memcpy(link_test_buf, hdr, sizeof(hdr));
+        int n = send(sock, link_test_buf, len, 0);
+        if (n > 0) {
+            res->bytes += n;
+            res->packets++;
+            seq++;
+        } else if (n < 0 && (errno == ENOMEM || link_test_timeout_errno(errno))) {
+            // lwIP out of buffers: let the WiFi driver drain them, then retry with the next datagram
+            link_test_yield();
+            last_yield = link_test_now_us();
+        } else if (n < 0) {
+            ret = errno;
+            break;
+        }
+    }
+    res->elapsed_ms = (uint32_t)((link_test_now_us() - start) / 1000);
+    // A paced source catches up after a yield; an unpaced one loses the time
+    if (!interval_us) res->yield_ms = (uint32_t)(yielded_us / 1000);
+
+    // The end marker must be negative even if nothing was sent
+    uint32_t fin = htonl((uint32_t)(seq ? -seq : -1));
+    memcpy(link_test_buf, &fin, sizeof(fin));
+    for (int i = 0; i < LINK_TEST_UDP_FIN_COUNT; i++) {
+        send(sock, link_test_buf, len, 0);
+    }
+    close(sock);
+    return ret;
+}
+
+static int link_test_echo(const link_test_config_t *cfg, link_test_result_t *res) {
+    int sock = link_test_bind(SOCK_DGRAM, cfg->port);
+    if (sock < 0) return errno;
+
+    int64_t start = link_test_now_us();
+    int64_t deadline = start + (int64_t)cfg->duration_ms * 1000;
+    int ret = 0;
+    while (!link_test_stop_requested && link_test_now_us() < deadline) {
+        struct sockaddr_in peer;
+        socklen_t peer_len = sizeof(peer);
+        int n = recvfrom(sock, link_test_buf, sizeof(link_test_buf), 0, (struct sockaddr*)&peer, &peer_len);
+        if (n > 0) {
+            sendto(sock, link_test_buf, n, 0, (struct sockaddr*)&peer, peer_len);
+            res->bytes += n;
+            res->packets++;
+        } else if (n < 0 && !link_test_timeout_errno(errno)) {
+            ret = errno;
+            break;
+        }
+    }
+    res->elapsed_ms = (uint32_t)((link_test_now_us() - start) / 1000);
+    close(sock);
+    return ret;
+}
+
+int link_test_run(const link_test_config_t *cfg, link_test_result_t *res) {
+    memset(res, 0, sizeof(*res));
+    res->mode = cfg->mode;
+
+    switch (cfg->mode) {
+        case LINK_TEST_TCP_RX: res->error = link_test_tcp_rx(cfg, res); break;
+        case LINK_TEST_TCP_TX: res->error = link_test_tcp_tx(cfg, res); break;
+        case LINK_TEST_UDP_RX: res->error = link_test_udp_rx(cfg, res); break;
+        case LINK_TEST_UDP_TX: res->error = link_test_udp_tx(cfg, res); break;
+        case LINK_TEST_ECHO:   res->error = link_test_echo(cfg, res); break;
+        default:               res->error = EINVAL; break;
+    }
+
+    uint32_t active_ms = res->elapsed_ms - res->yield_ms;
+    if (active_ms) {
+        res->throughput_kbps = (uint32_t)(res->bytes * 8 / active_ms);   // bits per ms == kbit/s
+    }
+    return res->error;
+}
+
+#ifdef ESP_PLATFORM
+
+#define LINK_TEST_DEFAULT_PORT      5001
+#define LINK_TEST_DEFAULT_DURATION  10      // seconds
+#define LINK_TEST_DEFAULT_RATE_KBPS 1000
+#define LINK_TEST_DEFAULT_LEN       1470
+
+static const char* TAG = "link_test";
+
+static link_test_config_t link_test_cfg;
+static link_test_result_t link_test_last;
+static volatile bool link_test_running = false;
+
+static void link_test_task(void *pvParameters) {
+    link_test_result_t res;
+    ESP_LOGI(TAG, "Starting %s test, port %u, %lu ms.", link_test_mode_name(link_test_cfg.mode),
+             link_test_cfg.port, (unsigned long)link_test_cfg.duration_ms);
+    link_test_run(&link_test_cfg, &res);
+    ESP_LOGI(TAG, "Finished: %llu bytes in %lu ms, %lu kbit/s, error %d.", (unsigned long long)res.bytes,
+             (unsigned long)res.elapsed_ms, (unsigned long)res.throughput_kbps, res.error);
+    link_test_last = res;
+    link_test_running = false;
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Writes the IPv4 address of the requesting client. Returns false for other peers.
+ */
+static bool link_test_peer_ipv4(httpd_req_t *req, char *ip, size_t ip_len) {
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr*)&ss, &len) != 0) return false;
+
+    struct in_addr in;
+    if (ss.ss_family == AF_INET) {
+        in = ((struct sockaddr_in*)&ss)->sin_addr;
+#if CONFIG_LWIP_IPV6
+    } else if (ss.ss_family == AF_INET6) {
+        // Dual-stack server socket: only IPv4-mapped peers (::ffff:a.b.c.d) can be reached by the sources
+        static const uint8_t mapped[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff };
+        uint8_t addr[16];
+        memcpy(addr, &((struct sockaddr_in6*)&ss)->sin6_addr, sizeof(addr));
+        if (memcmp(addr, mapped, sizeof(mapped)) != 0) return false;
+        memcpy(&in.s_addr, &addr[12], 4);
+#endif
+    } else {
+        return false;
+    }
+    return inet_ntop(AF_INET, &in, ip, ip_len) != NULL;
+}
+
+/**
+ * @brief Reads an unsigned form value, or returns the default if it is missing.
+ */
+static uint32_t link_test_form_uint(const char *body, const char *key, uint32_t def) {
+    char val[16];
+    if (httpd_query_key_value(body, key, val, sizeof(val)) != ESP_OK) return def;
+    return (uint32_t)strtoul(val, NULL, 10);
+}
+
+esp_err_t link_test_post_handler(httpd_req_t *req) {
+    char buf[CONFIG_WIFI_MANAGER_POST_BUF_SIZE];
+    int len = httpd_req_recv(req, buf, MIN(req->content_len, sizeof(buf) - 1));
+    if (len <= 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Missing form data");
+        return ESP_OK;
+    }
+    buf[len] = '\0';
+
+    char mode[12] = {0};
+    httpd_query_key_value(buf, "mode", mode, sizeof(mode));
+    if (strcmp(mode, "stop") == 0) {
+        link_test_stop();
+        httpd_resp_send(req, "Link test stopping.", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    if (link_test_running) {
+        httpd_resp_set_status(req, "409 Conflict");
+        httpd_resp_send(req, "Link test already running.", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    link_test_config_t cfg = {0};
+    cfg.mode = link_test_mode_from_name(mode);
+    if (cfg.mode == LINK_TEST_MODE_COUNT) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown mode");
+        return ESP_OK;
+    }
+    httpd_query_key_value(buf, "host", cfg.host, sizeof(cfg.host));
+    if (cfg.mode == LINK_TEST_TCP_TX || cfg.mode == LINK_TEST_UDP_TX) {
+        // Sources only send to the requesting client, so the device cannot be aimed at third parties
+        char peer[sizeof(cfg.host)];
+        if (!link_test_peer_ipv4(req, peer, sizeof(peer))) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Sources need an IPv4 client");
+            return ESP_OK;
+        }
+        if (strlen(cfg.host) == 0) {
+            strcpy(cfg.host, peer);
+        } else if (strcmp(cfg.host, peer) != 0) {
+            httpd_resp_send_err(req, HTTPD_403_FORBIDDEN, "Host must be the requesting client");
+            return ESP_OK;
+        }
+    }
+    cfg.port = (uint16_t)link_test_form_uint(buf, "port", LINK_TEST_DEFAULT_PORT);
+    cfg.duration_ms = MIN(link_test_form_uint(buf, "duration", LINK_TEST_DEFAULT_DURATION),
+                          CONFIG_WIFI_MANAGER_LINK_TEST_MAX_DURATION_SEC) * 1000;
+    cfg.rate_kbps = link_test_form_uint(buf, "rate", LINK_TEST_DEFAULT_RATE_KBPS);
+    cfg.len = (uint16_t)link_test_form_uint(buf, "len", LINK_TEST_DEFAULT_LEN);
+
+    link_test_cfg = cfg;
+    link_test_running = true;
+    // Cleared before the task exists, so a stop arriving before the run starts is not lost
+    link_test_stop_requested = false;
+    if (xTaskCreate(&link_test_task, "link_test_task", CONFIG_WIFI_MANAGER_LINK_TEST_TASK_STACK_SIZE, NULL,
+                    CONFIG_WIFI_MANAGER_TASK_PRIORITY, NULL) != pdPASS) {
+        link_test_running = false;
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to start link test");
+        return ESP_OK;
+    }
+
+    httpd_resp_set_status(req, "202 Accepted");
+    httpd_resp_send(req, "Link test started.", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+esp_err_t link_test_get_handler(httpd_req_t *req) {
+    bool running = link_test_running;
+    link_test_result_t res = link_test_last;
+    if (running) {
+        memset(&res, 0, sizeof(res));   // Results are published when the run is finished
+        res.mode = link_test_cfg.mode;
+    }
+    int rssi = 0;
+    uint8_t channel = 0;
+
+    wifi_ap_record_t info;
+    if (esp_wifi_sta_get_ap_info(&info) == ESP_OK) {
+        rssi = info.rssi;
+        channel = info.primary;
+    } else {
+        wifi_second_chan_t second;
+        esp_wifi_get_channel(&channel, &second);
+    }
+
+    char response[384];
+    snprintf(response, sizeof(response),
+             "{\"mode\":\"%s\",\"running\":%s,\"error\":%d,\"bytes\":%llu,\"elapsed_ms\":%lu,"
+             "\"yield_ms\":%lu,\"throughput_kbps\":%lu,\"packets\":%lu,\"lost\":%lu,\"out_of_order\":%lu,"
+             "\"jitter_us\":%lu,\"rssi\":%d,\"channel\":%u}",
+             link_test_mode_name(res.mode), running ? "true" : "false", res.error,
+             (unsigned long long)res.bytes, (unsigned long)res.elapsed_ms, (unsigned long)res.yield_ms,
+             (unsigned long)res.throughput_kbps,
+             (unsigned long)res.packets, (unsigned long)res.lost, (unsigned long)res.out_of_order,
+             (unsigned long)res.jitter_us, rssi, channel);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+#endif // ESP_PLATFORM
+
+#endif // !ESP_PLATFORM || CONFIG_WIFI_MANAGER_LINK_TEST
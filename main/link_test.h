@@ -0,0 +1,115 @@
+#ifndef LINK_TEST_H
+#define LINK_TEST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef ESP_PLATFORM
+#include "esp_err.h"
+#include "esp_http_server.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Link test modes. Sinks and the echo responder wait for a peer, sources connect to it.
+ */
+typedef enum {
+    LINK_TEST_TCP_RX = 0,   // TCP sink (peer: iperf -c)
+    LINK_TEST_TCP_TX,       // TCP source (peer: iperf -s)
+    LINK_TEST_UDP_RX,       // UDP sink, iperf2 datagram header (peer: iperf -u -c)
+    LINK_TEST_UDP_TX,       // UDP source, iperf2 datagram header (peer: iperf -u -s)
+    LINK_TEST_ECHO,         // UDP echo responder for round-trip latency
+    LINK_TEST_MODE_COUNT
+} link_test_mode_t;
+
+/**
+ * @brief Parameters of one link test run.
+ */
+typedef struct {
+    link_test_mode_t mode;
+    char host[40];          // Peer IPv4 address (sources only; via HTTP always the requesting client)
+    uint16_t port;          // Listen port (sinks, echo) or peer port (sources)
+    uint32_t duration_ms;   // Test duration; sinks and echo stop when it expires
+    uint32_t rate_kbps;     // UDP source target rate
+    uint16_t len;           // UDP datagram payload length
+} link_test_config_t;
+
+/**
+ * @brief Result of a link test run. Rates and jitter are computed from the first to the last packet.
+ * The throughput of an unpaced UDP source excludes yield_ms, the time it gave up the CPU to the idle task.
+ */
+typedef struct {
+    link_test_mode_t mode;
+    int error;              // 0 on success, otherwise errno of the failed socket call
+    uint64_t bytes;         // Payload bytes received (sinks) or sent (sources)
+    uint32_t elapsed_ms;
+    uint32_t yield_ms;      // Unpaced UDP source: time spent in periodic yields, excluded from throughput_kbps
+    uint32_t throughput_kbps;
+    uint32_t packets;       // UDP datagrams received, sent or echoed
+    uint32_t lost;          // UDP sink: missing sequence numbers
+    uint32_t out_of_order;  // UDP sink: late sequence numbers
+    uint32_t jitter_us;     // UDP sink: RFC 3550 interarrival jitter
+} link_test_result_t;
+
+/**
+ * @brief Returns the mode for a name ("tcp_rx", "tcp_tx", "udp_rx", "udp_tx", "echo"), or LINK_TEST_MODE_COUNT.
+ */
+link_test_mode_t link_test_mode_from_name(const char *name);
+
+/**
+ * @brief Returns the name of a mode.
+ */
+const char *link_test_mode_name(link_test_mode_t mode);
+
+/**
+ * @brief Runs one link test and blocks until it is finished, stopped or failed.
+ *
+ * Uses only BSD sockets and a single preallocated buffer, so it also runs on the host
+ * (e.g. over loopback against tools/link_test.py).
+ *
+ * @param cfg Test parameters
+ * @param res Filled with the result
+ * @return 0 on success, otherwise the errno of the failed socket call
+ */
+int link_test_run(const link_test_config_t *cfg, link_test_result_t *res);
+
+/**
+ * @brief Requests the running link test to stop. It returns within the socket poll interval.
+ *
+ * The request stays set until the next run is started via POST /link_test, so a run started
+ * directly with link_test_run() after a stop returns immediately.
+ */
+void link_test_stop(void);
+
+#ifdef ESP_PLATFORM
+/**
+ * @brief HTTP POST handler: Starts or stops a link test in a background task.
+ *
+ * Endpoint: /link_test (method: POST)
+ * Form format: application/x-www-form-urlencoded
+ * (e.g. mode=udp_rx&port=5001&duration=10, mode=tcp_tx&port=5001, mode=stop)
+ * Sources (tcp_tx, udp_tx) send to the requesting client; a different host is rejected with 403.
+ *
+ * @param req HTTP request pointer
+ * @return ESP_OK
+ */
+esp_err_t link_test_post_handler(httpd_req_t *req);
+
+/**
+ * @brief HTTP GET handler: Returns the current or last link test result with RSSI and channel as JSON.
+ *
+ * Endpoint: /link_test (method: GET)
+ *
+ * @param req HTTP request pointer
+ * @return ESP_OK
+ */
+esp_err_t link_test_get_handler(httpd_req_t *req);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LINK_TEST_H
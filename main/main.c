@@ -18,6 +18,11 @@ void app_main(void)
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
+#if CONFIG_WIFI_MANAGER_CONNECT_BENCH
+    // Runs before the manager takes over the radio
+    wifi_manager_connect_bench();
+#endif
+
     // Start the WiFi manager state machine (handles STA/AP logic)
     wifi_manager_start_main_task();
 
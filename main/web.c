@@ -1,8 +1,39 @@
 #include "web.h"
+#include "web_admission.h"
+#include "sdkconfig.h"
 #include "wifi_manager.h"
+#include "link_test.h"
 #include "esp_log.h"
 #include <string.h>
 
+// URI handlers registered by web_start_server(): /wifi, /wifi_reset and /wifi_status plus the optional ones
+enum {
+    WEB_URI_HANDLER_COUNT = 3
+#if CONFIG_WIFI_MANAGER_WEB_UI
+        + 1
+#endif
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
+        + 1
+#endif
+#if CONFIG_WIFI_MANAGER_LINK_TEST
+        + 2
+#endif
+};
+_Static_assert(CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS >= WEB_URI_HANDLER_COUNT,
+               "CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS is too small for the enabled endpoints");
+
+#if CONFIG_WIFI_MANAGER_WEB_UI && CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
+// The page rescans no faster than one client is admitted (plus timer slack), so its polls never get 429
+#if CONFIG_WIFI_MANAGER_RATE_LIMIT && CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_CLIENT_REFILL_MS >= 15000
+#define WEB_SCAN_INTERVAL_MS    (CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_CLIENT_REFILL_MS + 1000)
+#else
+#define WEB_SCAN_INTERVAL_MS    15000
+#endif
+#define WEB_STR(x)              WEB_STR_(x)
+#define WEB_STR_(x)             #x
+#endif
+
+#if CONFIG_WIFI_MANAGER_WEB_UI
 /**
  * @brief HTTP GET handler for the root ("/") URI. Serves the main HTML page.
  */
@@ -11,6 +42,17 @@ static esp_err_t root_get_handler(httpd_req_t *req) {
     httpd_resp_send(req, index_html, strlen(index_html));
     return ESP_OK;
 }
+#endif
+
+/**
+ * @brief Registers a URI handler behind admission control and logs a failed registration.
+ */
+static void web_register(httpd_handle_t server, const httpd_uri_t *uri, web_admission_class_t cls) {
+    esp_err_t err = web_admission_register_uri_handler(server, uri, cls);
+    if (err != ESP_OK) {
+        ESP_LOGE("web", "Failed to register %s: %s", uri->uri, esp_err_to_name(err));
+    }
+}
 
 /**
  * @brief Starts the HTTP server and registers all URI handlers, including WiFi manager endpoints.
@@ -18,22 +60,36 @@ static esp_err_t root_get_handler(httpd_req_t *req) {
  */
 httpd_handle_t web_start_server(void) {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    config.stack_size = CONFIG_WIFI_MANAGER_HTTPD_STACK_SIZE;
+    config.max_uri_handlers = CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS;
     httpd_handle_t server = NULL;
     if (httpd_start(&server, &config) == ESP_OK) {
+#if CONFIG_WIFI_MANAGER_WEB_UI
         httpd_uri_t root = { .uri = "/", .method = HTTP_GET, .handler = root_get_handler, .user_ctx = NULL };
-        httpd_register_uri_handler(server, &root);
+        web_register(server, &root, WEB_ADMISSION_STATUS);
+#endif
 
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
         httpd_uri_t scan_uri = { .uri = "/wifi_scan", .method = HTTP_GET, .handler = wifi_manager_scan_get_wifi_handler, .user_ctx = NULL };
-        httpd_register_uri_handler(server, &scan_uri);
+        web_register(server, &scan_uri, WEB_ADMISSION_SCAN);
+#endif
 
         httpd_uri_t wifi_post = { .uri = "/wifi", .method = HTTP_POST, .handler = wifi_manager_post_wifi_handler, .user_ctx = NULL };
-        httpd_register_uri_handler(server, &wifi_post);
+        web_register(server, &wifi_post, WEB_ADMISSION_CONFIG);
 
         httpd_uri_t wifi_reset = { .uri = "/wifi_reset", .method = HTTP_POST, .handler = wifi_manager_post_wifi_reset_handler, .user_ctx = NULL };
-        httpd_register_uri_handler(server, &wifi_reset);
+        web_register(server, &wifi_reset, WEB_ADMISSION_CONFIG);
 
         httpd_uri_t wifi_status = { .uri = "/wifi_status", .method = HTTP_GET, .handler = wifi_manager_get_wifi_status_handler, .user_ctx = NULL };
-        httpd_register_uri_handler(server, &wifi_status);
+        web_register(server, &wifi_status, WEB_ADMISSION_STATUS);
+
+#if CONFIG_WIFI_MANAGER_LINK_TEST
+        httpd_uri_t link_test_get = { .uri = "/link_test", .method = HTTP_GET, .handler = link_test_get_handler, .user_ctx = NULL };
+        web_register(server, &link_test_get, WEB_ADMISSION_STATUS);
+
+        httpd_uri_t link_test_post = { .uri = "/link_test", .method = HTTP_POST, .handler = link_test_post_handler, .user_ctx = NULL };
+        web_register(server, &link_test_post, WEB_ADMISSION_DIAG);
+#endif
 
         ESP_LOGI("web", "HTTP server started.");
     } else {
@@ -42,6 +98,7 @@ httpd_handle_t web_start_server(void) {
     return server;
 }
 
+#if CONFIG_WIFI_MANAGER_WEB_UI
 const char index_html[] = "\n"
         "<!DOCTYPE html>"
             "<html>"
@@ -54,6 +111,7 @@ const char index_html[] = "\n"
                         "async function loadWiFiStatus() {"
                             "try {"
                                 "const r=await fetch('/wifi_status');"
+                                "if(!r.ok)return;"
                                 "const s=await r.json();"
                                 "document.getElementById('status_connected').textContent=s.connected?'Yes':'No';"
                                 "document.getElementById('status_mode').textContent=s.mode;"
@@ -64,9 +122,11 @@ const char index_html[] = "\n"
                             "}"
                         "}"
 
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
                         "async function loadNetworks() {"
                             "try {"
                                 "const r=await fetch('/wifi_scan');"
+                                "if(!r.ok)return;"
                                 "const l=await r.json();"
                                 "const s=document.getElementById('ssid_select');"
                                 "s.innerHTML='';"
@@ -85,12 +145,15 @@ const char index_html[] = "\n"
                         "function fillSSID() {"
                             "document.getElementById('ssid').value=document.getElementById('ssid_select').value;"
                         "}"
+#endif
 
                         "window.onload=function() {"
                             "loadWiFiStatus();"
-                            "loadNetworks();"
                             "setInterval(loadWiFiStatus,3000);"
-                            "setInterval(loadNetworks, 3000);"
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
+                            "loadNetworks();"
+                            "setInterval(loadNetworks," WEB_STR(WEB_SCAN_INTERVAL_MS) ");"
+#endif
                         "};"
 
                     "</script>"
@@ -109,7 +172,11 @@ const char index_html[] = "\n"
                     "<fieldset>"
                         "<legend>WiFi Configuration</legend>"
                         "<form method='POST' action='/wifi'>"
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
                             "<p>SSID: <input id='ssid' name='ssid'><select id='ssid_select' onchange='fillSSID()'></select></p>"
+#else
+                            "<p>SSID: <input id='ssid' name='ssid'></p>"
+#endif
                             "<p>Password: <input type='password' name='password'></p>"
                             "<p><input type='submit' value='Connect'></form>"
                         "</form></p>"
@@ -120,4 +187,5 @@ const char index_html[] = "\n"
                     "</fieldset>"
                     
                 "</body>"
-            "</html>";
\ No newline at end of file
+            "</html>";
+#endif // CONFIG_WIFI_MANAGER_WEB_UI
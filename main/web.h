@@ -1,6 +1,7 @@
 #ifndef WEB_H
 #define WEB_H
 
+#include "sdkconfig.h"
 #include "esp_err.h"
 #include "esp_http_server.h"
 
@@ -13,10 +14,12 @@ extern "C" {
  */
 httpd_handle_t web_start_server(void);
 
+#if CONFIG_WIFI_MANAGER_WEB_UI
 /**
  * @brief HTML/JS/CSS frontend embedded as a C string array.
  */
 extern const char index_html[];
+#endif
 
 #ifdef __cplusplus
 }
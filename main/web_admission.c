@@ -0,0 +1,235 @@
+#include "web_admission.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include <string.h>
+
+#if CONFIG_WIFI_MANAGER_RATE_LIMIT
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include <stdio.h>
+#include <sys/param.h>
+
+#define WEB_ADMISSION_MAX_CLIENTS   CONFIG_WIFI_MANAGER_RATE_LIMIT_MAX_CLIENTS
+#define WEB_ADMISSION_MAX_ENDPOINTS CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS
+#define WEB_ADMISSION_MILLI         1000    // Bucket levels are kept in 1/1000 tokens
+
+static const char* TAG = "web_admission";
+
+/**
+ * @brief Token bucket rate. A refill_ms of 0 means no bucket.
+ */
+typedef struct {
+    uint32_t burst;         // Bucket capacity in tokens
+    uint32_t refill_ms;     // Time to refill one token
+} web_admission_rate_t;
+
+/**
+ * @brief Admission policy of a class: a request needs a token from both buckets.
+ */
+typedef struct {
+    web_admission_rate_t client;    // One bucket per client
+    web_admission_rate_t global;    // One bucket shared by all clients
+} web_admission_policy_t;
+
+// Handlers run one after another on the single httpd task, so every blocking radio request
+// delays all clients. Scan and config are capped by a global budget, and a per-client bucket
+// keeps one client from taking all of it. Cheap status requests and diagnostics, which run in
+// their own task, are only limited per client.
+static const web_admission_policy_t policies[WEB_ADMISSION_CLASS_COUNT] = {
+    [WEB_ADMISSION_STATUS] = { { CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_BURST, CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_REFILL_MS },
+                               { 0, 0 } },
+    [WEB_ADMISSION_SCAN]   = { { 1, CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_CLIENT_REFILL_MS },
+                               { CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_BURST, CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_REFILL_MS } },
+    [WEB_ADMISSION_CONFIG] = { { 1, CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_CLIENT_REFILL_MS },
+                               { CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_BURST, CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_REFILL_MS } },
+    [WEB_ADMISSION_DIAG]   = { { CONFIG_WIFI_MANAGER_RATE_LIMIT_DIAG_BURST, CONFIG_WIFI_MANAGER_RATE_LIMIT_DIAG_REFILL_MS },
+                               { 0, 0 } },
+};
+
+// A client retrying at full speed must not get a token every time the global bucket refills
+_Static_assert(CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_CLIENT_REFILL_MS >=
+               CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_REFILL_MS * CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_BURST,
+               "RATE_LIMIT_SCAN_CLIENT_REFILL_MS must be at least SCAN_REFILL_MS * SCAN_BURST");
+_Static_assert(CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_CLIENT_REFILL_MS >=
+               CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_REFILL_MS * CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_BURST,
+               "RATE_LIMIT_CONFIG_CLIENT_REFILL_MS must be at least CONFIG_REFILL_MS * CONFIG_BURST");
+
+typedef struct {
+    uint32_t level;         // Tokens * WEB_ADMISSION_MILLI
+    int64_t last_us;        // Time of the last refill
+} web_admission_bucket_t;
+
+typedef struct {
+    bool used;
+    uint8_t addr[16];       // IPv6 or IPv4-mapped peer address
+    int64_t last_seen_us;
+    web_admission_bucket_t buckets[WEB_ADMISSION_CLASS_COUNT];
+} web_admission_client_t;
+
+typedef struct {
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+    web_admission_class_t cls;
+} web_admission_endpoint_t;
+
+// All state is only touched from the httpd task; LRU client entry is evicted when full
+static web_admission_client_t clients[WEB_ADMISSION_MAX_CLIENTS];
+static web_admission_bucket_t global_buckets[WEB_ADMISSION_CLASS_COUNT];
+static web_admission_endpoint_t endpoints[WEB_ADMISSION_MAX_ENDPOINTS];
+static int endpoint_count = 0;
+
+/**
+ * @brief Reads the peer address of the request socket as 16 bytes (IPv4 is stored IPv4-mapped).
+ */
+static bool web_admission_peer_addr(httpd_req_t *req, uint8_t addr[16]) {
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr*)&ss, &len) != 0) return false;
+
+    memset(addr, 0, 16);
+    if (ss.ss_family == AF_INET) {
+        struct sockaddr_in *in = (struct sockaddr_in*)&ss;
+        addr[10] = 0xff;
+        addr[11] = 0xff;
+        memcpy(&addr[12], &in->sin_addr.s_addr, 4);
+        return true;
+    }
+#if CONFIG_LWIP_IPV6
+    if (ss.ss_family == AF_INET6) {
+        struct sockaddr_in6 *in6 = (struct sockaddr_in6*)&ss;
+        memcpy(addr, &in6->sin6_addr, 16);
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief Returns the table entry of the client, creating it with full buckets (evicting the LRU entry if needed).
+ */
+static web_admission_client_t *web_admission_get_client(const uint8_t addr[16], int64_t now) {
+    web_admission_client_t *victim = &clients[0];
+    for (int i = 0; i < WEB_ADMISSION_MAX_CLIENTS; i++) {
+        web_admission_client_t *c = &clients[i];
+        if (c->used && memcmp(c->addr, addr, 16) == 0) {
+            c->last_seen_us = now;
+            return c;
+        }
+        if (victim->used && (!c->used || c->last_seen_us < victim->last_seen_us)) {
+            victim = c;
+        }
+    }
+
+    victim->used = true;
+    memcpy(victim->addr, addr, 16);
+    victim->last_seen_us = now;
+    for (int k = 0; k < WEB_ADMISSION_CLASS_COUNT; k++) {
+        victim->buckets[k].level = policies[k].client.burst * WEB_ADMISSION_MILLI;
+        victim->buckets[k].last_us = now;
+    }
+    return victim;
+}
+
+/**
+ * @brief Refills the bucket. Returns 0 if a token is available, otherwise the seconds until the next token.
+ */
+static uint32_t web_admission_refill(web_admission_bucket_t *b, const web_admission_rate_t *r, int64_t now) {
+    uint32_t cap = r->burst * WEB_ADMISSION_MILLI;
+    // One token per refill_ms equals 1/refill_ms milli-tokens per microsecond
+    int64_t add = (now - b->last_us) / r->refill_ms;
+    if (b->level + add >= cap) {
+        b->level = cap;
+        b->last_us = now;
+    } else {
+        b->level += add;
+        b->last_us += add * r->refill_ms;
+    }
+
+    if (b->level >= WEB_ADMISSION_MILLI) return 0;
+    // Time since last_us already counts towards the next milli-token
+    int64_t wait_us = (int64_t)(WEB_ADMISSION_MILLI - b->level) * r->refill_ms - (now - b->last_us);
+    return (uint32_t)((wait_us + 999999) / 1000000);
+}
+
+/**
+ * @brief Rejects the request with "429 Too Many Requests" without reading the body.
+ */
+static esp_err_t web_admission_reject(httpd_req_t *req, uint32_t retry_after_s) {
+    char retry_after[12];
+    snprintf(retry_after, sizeof(retry_after), "%lu", (unsigned long)(retry_after_s ? retry_after_s : 1));
+    httpd_resp_set_status(req, "429 Too Many Requests");
+    httpd_resp_set_hdr(req, "Retry-After", retry_after);
+    httpd_resp_set_hdr(req, "Connection", "close");
+    httpd_resp_send(req, "Too many requests", HTTPD_RESP_USE_STRLEN);
+    return ESP_OK;
+}
+
+/**
+ * @brief Common handler of all admission controlled URIs. Takes a token from the client and the
+ * global bucket of the class before calling the wrapped handler; tokens are only taken if both admit.
+ */
+static esp_err_t web_admission_handler(httpd_req_t *req) {
+    web_admission_endpoint_t *ep = req->user_ctx;
+    const web_admission_policy_t *p = &policies[ep->cls];
+    int64_t now = esp_timer_get_time();
+    web_admission_bucket_t *cb = NULL, *gb = NULL;
+    uint32_t retry_after = 0;
+    uint8_t addr[16];
+
+    if (p->client.refill_ms && web_admission_peer_addr(req, addr)) {
+        cb = &web_admission_get_client(addr, now)->buckets[ep->cls];
+        retry_after = web_admission_refill(cb, &p->client, now);
+    }
+    if (p->global.refill_ms) {
+        gb = &global_buckets[ep->cls];
+        retry_after = MAX(retry_after, web_admission_refill(gb, &p->global, now));
+    }
+    if (retry_after) {
+        ESP_LOGD(TAG, "Rate limited %s", req->uri);
+        return web_admission_reject(req, retry_after);
+    }
+    if (cb) cb->level -= WEB_ADMISSION_MILLI;
+    if (gb) gb->level -= WEB_ADMISSION_MILLI;
+
+    // Hand the original context to the wrapped handler
+    req->user_ctx = ep->user_ctx;
+    return ep->handler(req);
+}
+
+esp_err_t web_admission_register_uri_handler(httpd_handle_t server, const httpd_uri_t *uri, web_admission_class_t cls) {
+    if (endpoint_count >= WEB_ADMISSION_MAX_ENDPOINTS) {
+        ESP_LOGE(TAG, "No endpoint slot left for %s", uri->uri);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Global buckets start full
+    if (endpoint_count == 0) {
+        for (int k = 0; k < WEB_ADMISSION_CLASS_COUNT; k++) {
+            global_buckets[k].level = policies[k].global.burst * WEB_ADMISSION_MILLI;
+            global_buckets[k].last_us = esp_timer_get_time();
+        }
+    }
+
+    web_admission_endpoint_t *ep = &endpoints[endpoint_count];
+    ep->handler = uri->handler;
+    ep->user_ctx = uri->user_ctx;
+    ep->cls = cls;
+
+    httpd_uri_t wrapped = *uri;
+    wrapped.handler = web_admission_handler;
+    wrapped.user_ctx = ep;
+    esp_err_t err = httpd_register_uri_handler(server, &wrapped);
+    if (err == ESP_OK) {
+        endpoint_count++;
+    }
+    return err;
+}
+
+#else
+
+esp_err_t web_admission_register_uri_handler(httpd_handle_t server, const httpd_uri_t *uri, web_admission_class_t cls) {
+    (void)cls;
+    return httpd_register_uri_handler(server, uri);
+}
+
+#endif // CONFIG_WIFI_MANAGER_RATE_LIMIT
@@ -0,0 +1,41 @@
+#ifndef WEB_ADMISSION_H
+#define WEB_ADMISSION_H
+
+#include "esp_err.h"
+#include "esp_http_server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Admission classes. Each class has its own buckets per client and, for blocking endpoints, one shared by all clients.
+ */
+typedef enum {
+    WEB_ADMISSION_STATUS = 0,   // Cheap GET endpoints ("/", /wifi_status), per client
+    WEB_ADMISSION_SCAN,         // Blocking radio scan (/wifi_scan), global and per client
+    WEB_ADMISSION_CONFIG,       // Endpoints tearing down the WiFi state (/wifi, /wifi_reset), global and per client
+    WEB_ADMISSION_DIAG,         // Diagnostics started in the background (POST /link_test), per client
+    WEB_ADMISSION_CLASS_COUNT
+} web_admission_class_t;
+
+/**
+ * @brief Registers a URI handler behind admission control.
+ *
+ * Requests are admitted if the buckets of the given class have a token left: the bucket of the
+ * client (keyed by peer IP) and, for the blocking scan and config endpoints, the global bucket.
+ * Otherwise "429 Too Many Requests" is returned without calling the handler. Without
+ * CONFIG_WIFI_MANAGER_RATE_LIMIT the handler is registered directly.
+ *
+ * @param server HTTP server handle
+ * @param uri URI handler description, copied on registration
+ * @param cls Admission class of the endpoint
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if no endpoint slot is left, or the httpd error
+ */
+esp_err_t web_admission_register_uri_handler(httpd_handle_t server, const httpd_uri_t *uri, web_admission_class_t cls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WEB_ADMISSION_H
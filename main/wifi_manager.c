@@ -1,24 +1,45 @@
 #include "wifi_manager.h"
+#include "sdkconfig.h"
 #include "esp_wifi.h"
 #include "esp_log.h"
 #include "esp_netif.h"
 #include "esp_event.h"
 #include "nvs_flash.h"
 #include "nvs.h"
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+#include "esp_timer.h"
+#include "mbedtls/pkcs5.h"
+#endif
+#if CONFIG_WIFI_MANAGER_USE_CJSON
 #include "cJSON.h"
+#endif
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#if CONFIG_WIFI_MANAGER_CONNECT_BENCH
+#include "freertos/event_groups.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 
 
-#define WIFI_MANAGER_STA_ATTEMPT_DURATION_MS     (1 * 60 * 1000) // 1 minutes in AP-Mode
-#define WIFI_MANAGER_AP_IDLE_TIMEOUT_MS          (1 * 60 * 1000) // 1 minutes in STA-Mode
-#define WIFI_MANAGER_AP_CLIENT_CHECK_INTERVAL_MS (5 * 1000)      // 5 seconds interval to check clients connected in AP-Mode
-#define WIFI_MANAGER_STA_RECONNECT_TIMEOUT_SEC   (60)            // 60 seconds to check if still connected while in STA-Mode   
+// All timings, buffer and task sizes are set via menuconfig ("WiFi Manager Configuration")
+#define WIFI_MANAGER_STA_ATTEMPT_DURATION_MS     CONFIG_WIFI_MANAGER_STA_ATTEMPT_DURATION_MS     // Time to try STA before AP fallback
+#define WIFI_MANAGER_STA_RECONNECT_TIMEOUT_SEC   CONFIG_WIFI_MANAGER_STA_RECONNECT_TIMEOUT_SEC   // Seconds to check if still connected while in STA-Mode
+#define WIFI_MANAGER_STA_MAX_LOST_CHECKS         CONFIG_WIFI_MANAGER_STA_MAX_LOST_CHECKS         // Lost checks in STA-Mode before AP fallback
+#define WIFI_MANAGER_CONNECT_TEST_WAIT_MS        CONFIG_WIFI_MANAGER_CONNECT_TEST_WAIT_MS        // Wait time when testing new credentials
+#if CONFIG_WIFI_MANAGER_AP_FALLBACK
+#define WIFI_MANAGER_AP_IDLE_TIMEOUT_MS          CONFIG_WIFI_MANAGER_AP_IDLE_TIMEOUT_MS          // Time without clients in AP-Mode
+#define WIFI_MANAGER_AP_CLIENT_CHECK_INTERVAL_MS CONFIG_WIFI_MANAGER_AP_CLIENT_CHECK_INTERVAL_MS // Interval to check clients connected in AP-Mode
+#endif
+#define WIFI_MANAGER_POST_BUF_SIZE               CONFIG_WIFI_MANAGER_POST_BUF_SIZE
+#if !CONFIG_WIFI_MANAGER_USE_CJSON
+#define WIFI_MANAGER_JSON_BUF_SIZE               CONFIG_WIFI_MANAGER_JSON_BUF_SIZE
+#endif
 #define WIFI_NAMESPACE "wifi_creds"
-#define MAX_SSID_LEN 32
-#define MAX_PASS_LEN 64
+#define MAX_SSID_LEN 33
+#define MAX_PASS_LEN 65   // 63 characters passphrase or 64 hex digits PMK, plus terminator
+#define WPA_PMK_LEN 32
+#define WPA_PMK_ITERATIONS 4096
 
 static const char* TAG = "wifi_manager";
 char saved_ssid[MAX_SSID_LEN];
@@ -32,6 +53,59 @@ int sta_mode_counter = 0;
 uint16_t ap_num = 0;
 wifi_ap_record_t *ap_records = NULL;
 
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+/**
+ * @brief Checks if the password is already a PMK (64 hex digits).
+ */
+static bool wifi_manager_is_pmk_hex(const char *password) {
+    if (strlen(password) != 2 * WPA_PMK_LEN) return false;
+    for (const char *p = password; *p; p++) {
+        if (!((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'f') || (*p >= 'A' && *p <= 'F'))) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Derives the WPA2 PMK (PBKDF2-HMAC-SHA1, SSID as salt) and writes it as 64 hex digits.
+ * The driver accepts the hex PMK in place of the passphrase and skips its own derivation.
+ */
+static esp_err_t wifi_manager_derive_pmk(const char *ssid, const char *password, char *pmk_hex, size_t pmk_hex_len) {
+    uint8_t pmk[WPA_PMK_LEN];
+
+    if (pmk_hex_len < 2 * WPA_PMK_LEN + 1) return ESP_ERR_INVALID_SIZE;
+
+    int64_t start = esp_timer_get_time();
+    int ret = mbedtls_pkcs5_pbkdf2_hmac_ext(MBEDTLS_MD_SHA1,
+                                            (const unsigned char*)password, strlen(password),
+                                            (const unsigned char*)ssid, strlen(ssid),
+                                            WPA_PMK_ITERATIONS, sizeof(pmk), pmk);
+    if (ret != 0) {
+        ESP_LOGE(TAG, "PMK derivation failed: -0x%04x", -ret);
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "PMK derived in %lld ms.", (esp_timer_get_time() - start) / 1000);
+
+    for (int i = 0; i < WPA_PMK_LEN; i++) {
+        snprintf(pmk_hex + 2 * i, 3, "%02x", pmk[i]);
+    }
+    memset(pmk, 0, sizeof(pmk));
+    return ESP_OK;
+}
+
+/**
+ * @brief Converts a password into the 64 hex digits PMK that is handed to the driver and stored.
+ * Empty passwords (open networks) and passwords that already are a PMK are copied unchanged.
+ */
+static esp_err_t wifi_manager_password_to_pmk(const char *ssid, const char *password, char *pmk_hex, size_t pmk_hex_len) {
+    if (strlen(password) == 0 || wifi_manager_is_pmk_hex(password)) {
+        strncpy(pmk_hex, password, pmk_hex_len - 1);
+        pmk_hex[pmk_hex_len - 1] = '\0';
+        return ESP_OK;
+    }
+    return wifi_manager_derive_pmk(ssid, password, pmk_hex, pmk_hex_len);
+}
+#endif
+
 /**
  * @brief Checks if WiFi credentials are stored in NVS.
  */
@@ -49,24 +123,65 @@ bool wifi_manager_wifi_credentials_exist(void) {
     }
     ESP_LOGW(TAG, "SSID aus NVS: '%s'", saved_ssid);
     len = sizeof(saved_pass);
-    err = nvs_get_str(nvs, "wifi_pass", saved_pass, &len);
-    if (err != ESP_OK) {
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+    err = nvs_get_str(nvs, "wifi_pmk", saved_pass, &len);
+    if (err == ESP_OK) {
         nvs_close(nvs);
-        return false;
+        return true;
     }
 
+    // Credentials saved by an older firmware: convert the passphrase once
+    len = sizeof(saved_pass);
+    err = nvs_get_str(nvs, "wifi_pass", saved_pass, &len);
     nvs_close(nvs);
+    if (err != ESP_OK) {
+        return false;
+    }
+    ESP_LOGI(TAG, "Converting stored passphrase to PMK.");
+    char pmk_hex[MAX_PASS_LEN];
+    err = wifi_manager_password_to_pmk(saved_ssid, saved_pass, pmk_hex, sizeof(pmk_hex));
+    memset(saved_pass, 0, sizeof(saved_pass));
+    if (err != ESP_OK) {
+        return false;
+    }
+    // Connect with the PMK from now on, the plaintext is erased by the save
+    strcpy(saved_pass, pmk_hex);
+    wifi_manager_save_wifi_credentials(saved_ssid, saved_pass);
     return true;
+#else
+    err = nvs_get_str(nvs, "wifi_pass", saved_pass, &len);
+    if (err != ESP_OK) {
+        // Credentials saved with CONFIG_WIFI_MANAGER_STORE_PMK: the driver accepts the hex PMK as password
+        len = sizeof(saved_pass);
+        err = nvs_get_str(nvs, "wifi_pmk", saved_pass, &len);
+    }
+    nvs_close(nvs);
+    return err == ESP_OK;
+#endif
 }
 
 /**
  * @brief Saves WiFi credentials (SSID and password) into NVS.
+ * With CONFIG_WIFI_MANAGER_STORE_PMK the PMK is derived for this SSID and stored instead of the passphrase.
  */
 void wifi_manager_save_wifi_credentials(const char* ssid, const char* password) {
     nvs_handle_t nvs;
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+    // The PMK is salted with the SSID, so it is derived again on every save
+    char pmk_hex[MAX_PASS_LEN] = {0};
+    if (wifi_manager_password_to_pmk(ssid, password, pmk_hex, sizeof(pmk_hex)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save WiFi credentials.");
+        return;
+    }
+#endif
     if (nvs_open(WIFI_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
         nvs_set_str(nvs, "wifi_ssid", ssid);
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+        nvs_set_str(nvs, "wifi_pmk", pmk_hex);
+        nvs_erase_key(nvs, "wifi_pass");   // Never keep the plaintext passphrase
+#else
         nvs_set_str(nvs, "wifi_pass", password);
+#endif
         nvs_commit(nvs);
         nvs_close(nvs);
         ESP_LOGI(TAG, "WiFi credentials saved: SSID='%s'", ssid);
@@ -83,6 +198,7 @@ void wifi_manager_delete_wifi_credentials(void) {
     if (nvs_open(WIFI_NAMESPACE, NVS_READWRITE, &nvs) == ESP_OK) {
         nvs_erase_key(nvs, "wifi_ssid");
         nvs_erase_key(nvs, "wifi_pass");
+        nvs_erase_key(nvs, "wifi_pmk");
         nvs_commit(nvs);
         nvs_close(nvs);
         memset(saved_ssid, 0, sizeof(saved_ssid));
@@ -133,6 +249,7 @@ void wifi_manager_connect_sta(const char *ssid, const char *password) {
 
 }
 
+#if CONFIG_WIFI_MANAGER_AP_FALLBACK
 /**
  * @brief Starts the ESP32 in Access Point (AP) mode.
  */
@@ -146,10 +263,11 @@ void wifi_manager_start_ap(void) {
     esp_wifi_init(&cfg);
     wifi_config_t ap_config = {
         .ap = {
-            .ssid = "ESP32-AP",
-            .ssid_len = 8,
-            .password = "esp32pass",
-            .max_connection = 4,
+            .ssid = CONFIG_WIFI_MANAGER_AP_SSID,
+            .ssid_len = sizeof(CONFIG_WIFI_MANAGER_AP_SSID) - 1,
+            .password = CONFIG_WIFI_MANAGER_AP_PASSWORD,
+            .channel = CONFIG_WIFI_MANAGER_AP_CHANNEL,
+            .max_connection = CONFIG_WIFI_MANAGER_AP_MAX_STA_CONN,
             .authmode = WIFI_AUTH_WPA_WPA2_PSK
         }
     };
@@ -157,7 +275,7 @@ void wifi_manager_start_ap(void) {
     esp_wifi_set_config(WIFI_IF_AP, &ap_config);
     sta_mode_counter = 0;
     esp_wifi_start();
-    ESP_LOGI(TAG, "Started AP mode: SSID: ESP32-AP, PASS: esp32pass");
+    ESP_LOGI(TAG, "Started AP mode: SSID: %s", CONFIG_WIFI_MANAGER_AP_SSID);
 }
 
 /**
@@ -167,6 +285,7 @@ void wifi_manager_stop_ap(void) {
     esp_wifi_stop();
     ESP_LOGI(TAG, "Stopped AP mode.");
 }
+#endif // CONFIG_WIFI_MANAGER_AP_FALLBACK
 
 /**
  * @brief The main WiFi state/task machine. Handles STA/AP switching and all timing logic.
@@ -175,11 +294,13 @@ void wifi_manager_stop_ap(void) {
 static void wifi_manager_main_task(void *pvParameters) {
     while (1) {
 
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
         // Perform initial WiFi scan
         esp_err_t err = esp_wifi_scan_start(NULL, true);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Scan start failed: %s", esp_err_to_name(err));
         }
+#endif
 
         ESP_LOGI(TAG, "Boot: saved_ssid='%s'", saved_ssid);
 
@@ -187,7 +308,7 @@ static void wifi_manager_main_task(void *pvParameters) {
             ESP_LOGI(TAG, "Found WiFi credentials in NVS.");
             if (strlen(saved_ssid) == 0) {
                 ESP_LOGW(TAG, "SSID is empty despite NVS entry. Skipping STA mode.");
-                goto start_apsta_mode;
+                goto sta_failed;
             }
 
             // Attempt to connect in STA mode
@@ -226,8 +347,8 @@ static void wifi_manager_main_task(void *pvParameters) {
                         }
                     }
                     vTaskDelay(pdMS_TO_TICKS(1000));
-                    if (sta_mode_counter > 10) {
-                        goto start_apsta_mode;
+                    if (sta_mode_counter > WIFI_MANAGER_STA_MAX_LOST_CHECKS) {
+                        goto sta_failed;
                     }
                 }
                 continue;
@@ -238,14 +359,17 @@ static void wifi_manager_main_task(void *pvParameters) {
             ESP_LOGI(TAG, "No WiFi credentials in NVS.");
         }
 
-start_apsta_mode:
-        
+sta_failed:
+        wifi_manager_sta_connected = false;
+
+#if CONFIG_WIFI_MANAGER_AP_FALLBACK
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
         err = esp_wifi_scan_start(NULL, true);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Scan start failed: %s", esp_err_to_name(err));
         }
+#endif
 
-        wifi_manager_sta_connected = false;
         // Attempt to connect in AP mode
         wifi_manager_start_ap();
 
@@ -265,13 +389,196 @@ start_apsta_mode:
 
         ESP_LOGI(TAG, "No AP clients for %d seconds. Restarting cycle.", WIFI_MANAGER_AP_IDLE_TIMEOUT_MS / 1000);
         wifi_manager_stop_ap();
+#else
+        // No AP fallback: retry STA mode after the attempt duration
+        sta_mode_counter = 0;
+        vTaskDelay(pdMS_TO_TICKS(WIFI_MANAGER_STA_ATTEMPT_DURATION_MS));
+#endif
+    }
+}
+
+#if CONFIG_WIFI_MANAGER_CONNECT_BENCH
+#define WIFI_MANAGER_BENCH_TIMEOUT_MS   15000
+#define WIFI_MANAGER_BENCH_RUNS         CONFIG_WIFI_MANAGER_CONNECT_BENCH_RUNS
+#define WIFI_MANAGER_BENCH_CONNECTED    BIT0
+#define WIFI_MANAGER_BENCH_GOT_IP       BIT1
+#define WIFI_MANAGER_BENCH_DISCONNECTED BIT2
+#define WIFI_MANAGER_BENCH_ALL          (WIFI_MANAGER_BENCH_CONNECTED | WIFI_MANAGER_BENCH_GOT_IP | WIFI_MANAGER_BENCH_DISCONNECTED)
+
+typedef struct {
+    int64_t connected_ms;   // Start until WIFI_EVENT_STA_CONNECTED
+    int64_t got_ip_ms;      // Start until IP_EVENT_STA_GOT_IP
+    int64_t cpu_ms;         // CPU time outside the idle tasks until IP_EVENT_STA_GOT_IP
+} wifi_manager_bench_sample_t;
+
+static EventGroupHandle_t bench_events;
+
+static void wifi_manager_bench_event_handler(void *arg, esp_event_base_t base, int32_t id, void *data) {
+    if (base == WIFI_EVENT && id == WIFI_EVENT_STA_CONNECTED) {
+        xEventGroupSetBits(bench_events, WIFI_MANAGER_BENCH_CONNECTED);
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        xEventGroupSetBits(bench_events, WIFI_MANAGER_BENCH_DISCONNECTED);
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        xEventGroupSetBits(bench_events, WIFI_MANAGER_BENCH_GOT_IP);
     }
 }
 
+/**
+ * @brief Returns the run time in microseconds all cores spent outside their idle tasks since boot.
+ */
+static int64_t wifi_manager_bench_cpu_us(void) {
+    UBaseType_t count = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *tasks = malloc(count * sizeof(TaskStatus_t));
+    if (tasks == NULL) return 0;
+
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    count = uxTaskGetSystemState(tasks, count, &total);
+    int64_t busy = (int64_t)total * portNUM_PROCESSORS;
+    for (UBaseType_t i = 0; i < count; i++) {
+        if (strncmp(tasks[i].pcTaskName, "IDLE", 4) == 0) busy -= tasks[i].ulRunTimeCounter;
+    }
+    free(tasks);
+    return busy;
+}
+
+/**
+ * @brief Connects once and measures it.
+ *
+ * boot: measured from esp_wifi_init(), like a connect after power-up (fresh driver, RAM storage only).
+ * Otherwise: the running connection is dropped and measured from esp_wifi_connect(), like a reconnect.
+ */
+static bool wifi_manager_bench_connect(bool boot, const char *password, wifi_manager_bench_sample_t *s) {
+    if (boot) {
+        esp_wifi_stop();
+        esp_wifi_deinit();
+    } else {
+        xEventGroupClearBits(bench_events, WIFI_MANAGER_BENCH_ALL);
+        esp_wifi_disconnect();
+        xEventGroupWaitBits(bench_events, WIFI_MANAGER_BENCH_DISCONNECTED, pdFALSE, pdTRUE,
+                            pdMS_TO_TICKS(WIFI_MANAGER_BENCH_TIMEOUT_MS));
+    }
+    xEventGroupClearBits(bench_events, WIFI_MANAGER_BENCH_ALL);
+
+    int64_t cpu_start = wifi_manager_bench_cpu_us();
+    int64_t start = esp_timer_get_time();
+    if (boot) {
+        wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+        esp_wifi_init(&cfg);
+        esp_wifi_set_storage(WIFI_STORAGE_RAM);     // Keep the benchmark passphrase out of nvs.net80211
+        esp_wifi_set_mode(WIFI_MODE_STA);
+        wifi_config_t wifi_config = {0};
+        strncpy((char*)wifi_config.sta.ssid, CONFIG_WIFI_MANAGER_CONNECT_BENCH_SSID, sizeof(wifi_config.sta.ssid));
+        strncpy((char*)wifi_config.sta.password, password, sizeof(wifi_config.sta.password));
+        esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+        memset(&wifi_config, 0, sizeof(wifi_config));
+        esp_wifi_start();
+    }
+    esp_wifi_connect();
+
+    EventBits_t bits = xEventGroupWaitBits(bench_events, WIFI_MANAGER_BENCH_CONNECTED, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(WIFI_MANAGER_BENCH_TIMEOUT_MS));
+    if (!(bits & WIFI_MANAGER_BENCH_CONNECTED)) return false;
+    s->connected_ms = (esp_timer_get_time() - start) / 1000;
+
+    bits = xEventGroupWaitBits(bench_events, WIFI_MANAGER_BENCH_GOT_IP, pdFALSE, pdTRUE,
+                               pdMS_TO_TICKS(WIFI_MANAGER_BENCH_TIMEOUT_MS));
+    if (!(bits & WIFI_MANAGER_BENCH_GOT_IP)) return false;
+    s->got_ip_ms = (esp_timer_get_time() - start) / 1000;
+    s->cpu_ms = (wifi_manager_bench_cpu_us() - cpu_start) / 1000;
+    return true;
+}
+
+static void wifi_manager_bench_report(const char *label, const wifi_manager_bench_sample_t *s, int n) {
+    if (n == 0) {
+        ESP_LOGW(TAG, "Bench %-20s no successful connect", label);
+        return;
+    }
+    wifi_manager_bench_sample_t sum = {0}, min = s[0], max = s[0];
+    for (int i = 0; i < n; i++) {
+        sum.connected_ms += s[i].connected_ms;
+        sum.got_ip_ms += s[i].got_ip_ms;
+        sum.cpu_ms += s[i].cpu_ms;
+        min.connected_ms = MIN(min.connected_ms, s[i].connected_ms);
+        max.connected_ms = MAX(max.connected_ms, s[i].connected_ms);
+        min.cpu_ms = MIN(min.cpu_ms, s[i].cpu_ms);
+        max.cpu_ms = MAX(max.cpu_ms, s[i].cpu_ms);
+    }
+    ESP_LOGI(TAG, "Bench %-20s n=%d connected %lld ms (%lld..%lld), got IP %lld ms, CPU %lld ms (%lld..%lld)",
+             label, n, sum.connected_ms / n, min.connected_ms, max.connected_ms, sum.got_ip_ms / n,
+             sum.cpu_ms / n, min.cpu_ms, max.cpu_ms);
+}
+
+void wifi_manager_connect_bench(void) {
+    static wifi_manager_bench_sample_t samples[4][WIFI_MANAGER_BENCH_RUNS];
+    static const char *const labels[4] = { "passphrase boot", "passphrase reconnect", "PMK boot", "PMK reconnect" };
+    int counts[4] = {0};
+    char pmk_hex[MAX_PASS_LEN];
+
+    if (wifi_manager_derive_pmk(CONFIG_WIFI_MANAGER_CONNECT_BENCH_SSID, CONFIG_WIFI_MANAGER_CONNECT_BENCH_PASSWORD,
+                                pmk_hex, sizeof(pmk_hex)) != ESP_OK) {
+        return;
+    }
+
+    bench_events = xEventGroupCreate();
+    esp_event_handler_instance_t wifi_handler, ip_handler;
+    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, wifi_manager_bench_event_handler, NULL, &wifi_handler);
+    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, wifi_manager_bench_event_handler, NULL, &ip_handler);
+    esp_netif_t *netif = esp_netif_create_default_wifi_sta();
+
+    // Alternate passphrase and PMK so both see the same AP and channel conditions
+    for (int run = 0; run < WIFI_MANAGER_BENCH_RUNS; run++) {
+        for (int v = 0; v < 2; v++) {
+            const char *password = v ? pmk_hex : CONFIG_WIFI_MANAGER_CONNECT_BENCH_PASSWORD;
+            int boot = 2 * v, reconnect = 2 * v + 1;
+            if (!wifi_manager_bench_connect(true, password, &samples[boot][counts[boot]])) continue;
+            counts[boot]++;
+            if (wifi_manager_bench_connect(false, password, &samples[reconnect][counts[reconnect]])) counts[reconnect]++;
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        wifi_manager_bench_report(labels[i], samples[i], counts[i]);
+    }
+
+    esp_wifi_stop();
+    esp_wifi_deinit();
+    esp_netif_destroy_default_wifi(netif);
+    esp_event_handler_instance_unregister(WIFI_EVENT, ESP_EVENT_ANY_ID, wifi_handler);
+    esp_event_handler_instance_unregister(IP_EVENT, IP_EVENT_STA_GOT_IP, ip_handler);
+    vEventGroupDelete(bench_events);
+    memset(pmk_hex, 0, sizeof(pmk_hex));
+}
+#endif // CONFIG_WIFI_MANAGER_CONNECT_BENCH
+
 void wifi_manager_start_main_task(void) {
-    xTaskCreate(&wifi_manager_main_task, "wifi_manager_main_task", 4096, NULL, 5, NULL);
+    xTaskCreate(&wifi_manager_main_task, "wifi_manager_main_task", CONFIG_WIFI_MANAGER_TASK_STACK_SIZE, NULL,
+                CONFIG_WIFI_MANAGER_TASK_PRIORITY, NULL);
 }
 
+#if !CONFIG_WIFI_MANAGER_USE_CJSON
+/**
+ * @brief Copies a string into a JSON string literal body, escaping quotes, backslashes and control characters.
+ * The output is always NUL-terminated and truncated to fit.
+ */
+static void wifi_manager_json_escape(char *dst, size_t dst_len, const char *src) {
+    size_t o = 0;
+    for (; *src && o + 1 < dst_len; src++) {
+        unsigned char c = (unsigned char)*src;
+        if (c == '"' || c == '\\') {
+            if (o + 2 >= dst_len) break;
+            dst[o++] = '\\';
+            dst[o++] = c;
+        } else if (c < 0x20) {
+            if (o + 6 >= dst_len) break;
+            o += snprintf(dst + o, dst_len - o, "\\u%04x", c);
+        } else {
+            dst[o++] = c;
+        }
+    }
+    dst[o] = '\0';
+}
+#endif
+
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
 esp_err_t wifi_manager_scan_get_wifi_handler(httpd_req_t *req) {
     
     esp_err_t err = esp_wifi_scan_start(NULL, true);
@@ -286,6 +593,7 @@ esp_err_t wifi_manager_scan_get_wifi_handler(httpd_req_t *req) {
 
     esp_wifi_scan_get_ap_records(&ap_num, ap_records);
 
+#if CONFIG_WIFI_MANAGER_USE_CJSON
     cJSON *root = cJSON_CreateArray();
     for (int i = 0; i < ap_num; i++) {
         cJSON *item = cJSON_CreateObject();
@@ -302,14 +610,33 @@ esp_err_t wifi_manager_scan_get_wifi_handler(httpd_req_t *req) {
     free(ap_records);
     cJSON_Delete(root);
     free((void*)json_str);
+#else
+    // Stream one object per network to keep the buffer size independent of the AP count
+    char entry[128];
+    char ssid[2 * 32 + 1];
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send_chunk(req, "[", 1);
+    for (int i = 0; i < ap_num; i++) {
+        wifi_manager_json_escape(ssid, sizeof(ssid), (const char*)ap_records[i].ssid);
+        int len = snprintf(entry, sizeof(entry), "%s{\"ssid\":\"%s\",\"rssi\":%d,\"secure\":%s}",
+                           i ? "," : "", ssid, ap_records[i].rssi,
+                           ap_records[i].authmode != WIFI_AUTH_OPEN ? "true" : "false");
+        httpd_resp_send_chunk(req, entry, MIN(len, (int)sizeof(entry) - 1));
+    }
+    httpd_resp_send_chunk(req, "]", 1);
+    httpd_resp_send_chunk(req, NULL, 0);
+
+    free(ap_records);
+#endif
     return ESP_OK;
 }
+#endif // CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
 
 esp_err_t wifi_manager_wifi_connect_test(const char *ssid, const char *password) {
     ESP_LOGI(TAG, "Testing connection to SSID: %s", ssid);
 
     wifi_manager_connect_sta(ssid, password);
-    vTaskDelay(pdMS_TO_TICKS(3000)); // Wait 3 seconds for connection
+    vTaskDelay(pdMS_TO_TICKS(WIFI_MANAGER_CONNECT_TEST_WAIT_MS)); // Wait for connection
 
     wifi_ap_record_t info;
     if (esp_wifi_sta_get_ap_info(&info) == ESP_OK) {
@@ -323,11 +650,11 @@ esp_err_t wifi_manager_wifi_connect_test(const char *ssid, const char *password)
 }
 
 esp_err_t wifi_manager_post_wifi_handler(httpd_req_t *req) {
-    char buf[256];
+    char buf[WIFI_MANAGER_POST_BUF_SIZE];
     int ret, remaining = req->content_len;
 
     while (remaining > 0) {
-        if ((ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf)))) <= 0) {
+        if ((ret = httpd_req_recv(req, buf, MIN(remaining, sizeof(buf) - 1))) <= 0) {
             return ESP_FAIL;
         }
         remaining -= ret;
@@ -335,7 +662,7 @@ esp_err_t wifi_manager_post_wifi_handler(httpd_req_t *req) {
     }
 
     char ssid[64] = {0};
-    char password[64] = {0};
+    char password[MAX_PASS_LEN] = {0};
     char *ssid_ptr = strstr(buf, "ssid=");
     char *pass_ptr = strstr(buf, "password=");
 
@@ -351,7 +678,20 @@ esp_err_t wifi_manager_post_wifi_handler(httpd_req_t *req) {
         strncpy(password, pass_ptr, sizeof(password) - 1);
     }
 
-    ESP_LOGI(TAG, "Received: SSID='%s', Password='%s'", ssid, password);
+    ESP_LOGI(TAG, "Received: SSID='%s'", ssid);
+
+#if CONFIG_WIFI_MANAGER_STORE_PMK
+    // Test with the PMK, so the driver never writes the plaintext to its own NVS (nvs.net80211)
+    char pmk_hex[MAX_PASS_LEN];
+    esp_err_t pmk_err = wifi_manager_password_to_pmk(ssid, password, pmk_hex, sizeof(pmk_hex));
+    memset(password, 0, sizeof(password));
+    memset(buf, 0, sizeof(buf));
+    if (pmk_err != ESP_OK) {
+        httpd_resp_send(req, "Connection failed. Please check credentials.", HTTPD_RESP_USE_STRLEN);
+        return ESP_FAIL;
+    }
+    strcpy(password, pmk_hex);
+#endif
 
     esp_err_t result = wifi_manager_wifi_connect_test(ssid, password);
 
@@ -405,7 +745,11 @@ esp_err_t wifi_manager_get_wifi_status_handler(httpd_req_t *req) {
     wifi_mode_t mode;
     wifi_config_t conf;
     char ip[16] = "0.0.0.0";
-    char ssid[33] = "ESP32-AP"; // Standard-AP-Name
+#if CONFIG_WIFI_MANAGER_AP_FALLBACK
+    char ssid[33] = CONFIG_WIFI_MANAGER_AP_SSID; // Standard-AP-Name
+#else
+    char ssid[33] = "";
+#endif
     bool connected = false;
 
     esp_wifi_get_mode(&mode);
@@ -428,6 +772,7 @@ esp_err_t wifi_manager_get_wifi_status_handler(httpd_req_t *req) {
         connected = ip_info.ip.addr != 0;
     }
 
+#if CONFIG_WIFI_MANAGER_USE_CJSON
     cJSON *root = cJSON_CreateObject();
 
     if (mode == WIFI_MODE_STA) {
@@ -447,6 +792,23 @@ esp_err_t wifi_manager_get_wifi_status_handler(httpd_req_t *req) {
     httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
     free((void*)response);
     cJSON_Delete(root);
+#else
+    char response[WIFI_MANAGER_JSON_BUF_SIZE];
+    char ssid_escaped[2 * sizeof(ssid) + 1];
+    const char *mode_str = "Unknown";
+
+    if (mode == WIFI_MODE_STA) {
+        mode_str = "Station";
+    } else if (mode == WIFI_MODE_APSTA) {
+        mode_str = "Accesspoint";
+    }
+
+    wifi_manager_json_escape(ssid_escaped, sizeof(ssid_escaped), ssid);
+    snprintf(response, sizeof(response), "{\"mode\":\"%s\",\"ssid\":\"%s\",\"ip\":\"%s\",\"connected\":%s}",
+             mode_str, ssid_escaped, ip, connected ? "true" : "false");
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, response, HTTPD_RESP_USE_STRLEN);
+#endif
 
     return ESP_OK;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef WIFI_MANAGER_H
 #define WIFI_MANAGER_H
 
+#include "sdkconfig.h"
 #include "esp_err.h"
 #include "esp_http_server.h"
 
@@ -17,6 +18,7 @@ extern bool wifi_manager_sta_connected;
  */
 void wifi_manager_init(void);
 
+#if CONFIG_WIFI_MANAGER_SCAN_ENDPOINT
 /**
  * @brief HTTP GET handler: Scans for WiFi networks and returns a JSON array.
  *
@@ -26,6 +28,7 @@ void wifi_manager_init(void);
  * @return ESP_OK on success, ESP_FAIL on error
  */
 esp_err_t wifi_manager_scan_get_wifi_handler(httpd_req_t *req);
+#endif
 
 /**
  * @brief HTTP POST handler: Receives WiFi credentials from the web form and attempts to connect.
@@ -46,16 +49,19 @@ esp_err_t wifi_manager_post_wifi_handler(httpd_req_t *req);
  */
 void wifi_manager_connect_sta(const char *ssid, const char *password);
 
+#if CONFIG_WIFI_MANAGER_AP_FALLBACK
 /**
- * @brief Starts the ESP32 in Access Point (AP) mode with default credentials.
+ * @brief Starts the ESP32 in Access Point (AP) mode with the credentials from menuconfig.
  */
 void wifi_manager_start_ap(void);
+#endif
 
 /**
  * @brief Checks if valid WiFi credentials are present in NVS and loads them into RAM.
  * 
- * This function verifies if SSID and password exist in the non-volatile storage
+ * This function verifies if SSID and password (or derived PMK) exist in the non-volatile storage
  * and populates the global variables `saved_ssid` and `saved_pass`.
+ * A plaintext passphrase left by an older firmware is converted to a PMK.
  *
  * @return true if valid credentials were found, false otherwise
  */
@@ -64,6 +70,9 @@ bool wifi_manager_wifi_credentials_exist(void);
 /**
  * @brief Saves the provided SSID and password into NVS.
  *
+ * With CONFIG_WIFI_MANAGER_STORE_PMK enabled, the WPA2 PMK is derived from the password
+ * and SSID and stored as 64 hex digits instead of the password.
+ *
  * @param ssid SSID to save
  * @param password Password to save
  */
@@ -85,6 +94,17 @@ void wifi_manager_delete_wifi_credentials(void);
  */
 void wifi_manager_start_main_task(void);
 
+#if CONFIG_WIFI_MANAGER_CONNECT_BENCH
+/**
+ * @brief Measures connect latency and CPU time with the passphrase and with the derived PMK.
+ *
+ * Connects CONFIG_WIFI_MANAGER_CONNECT_BENCH_RUNS times to the benchmark network with each key, after a
+ * fresh driver init (boot) and after a disconnect (reconnect), and logs average, minimum and maximum.
+ * Must be called before the WiFi manager task is started; the driver is deinitialized afterwards.
+ */
+void wifi_manager_connect_bench(void);
+#endif
+
 /**
  * @brief Attempts to connect to a WiFi network to test the given credentials.
  *
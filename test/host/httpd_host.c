@@ -0,0 +1,77 @@
+#include "httpd_host.h"
+#include "sdkconfig.h"
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#define HOST_MAX_URIS 32
+
+int64_t host_now_us = 0;
+void *host_handler_ctx = NULL;
+
+static host_uri_t uris[HOST_MAX_URIS];
+static int uri_count = 0;
+static bool handler_called = false;
+
+int64_t esp_timer_get_time(void) {
+    return host_now_us;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri) {
+    (void)handle;
+    if (uri_count >= HOST_MAX_URIS) return ESP_ERR_NO_MEM;
+    uris[uri_count++] = (host_uri_t){ uri->uri, uri->handler, uri->user_ctx };
+    return ESP_OK;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *req) {
+    return req->sockfd;
+}
+
+// Socket n belongs to client 192.168.4.(n + 2)
+int host_getpeername(int sockfd, struct sockaddr *addr, socklen_t *addrlen) {
+    struct sockaddr_in in = { .sin_family = AF_INET };
+    in.sin_addr.s_addr = htonl(0xC0A80400u + 2 + sockfd);
+    memcpy(addr, &in, sizeof(in));
+    *addrlen = sizeof(in);
+    return 0;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *req, const char *status) {
+    req->status = atoi(status);
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *req, const char *field, const char *value) {
+    if (strcmp(field, "Retry-After") == 0) {
+        strncpy(req->retry_after, value, sizeof(req->retry_after) - 1);
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, long len) {
+    (void)req; (void)buf; (void)len;
+    return ESP_OK;
+}
+
+esp_err_t host_handler(httpd_req_t *req) {
+    handler_called = true;
+    host_handler_ctx = req->user_ctx;
+    return ESP_OK;
+}
+
+const host_uri_t *host_find(const char *uri) {
+    for (int i = 0; i < uri_count; i++) {
+        if (strcmp(uris[i].uri, uri) == 0) return &uris[i];
+    }
+    return NULL;
+}
+
+bool host_dispatch(const host_uri_t *r, int client, httpd_req_t *out) {
+    httpd_req_t req = { .uri = r->uri, .user_ctx = r->user_ctx, .sockfd = client, .status = 200 };
+    handler_called = false;
+    r->handler(&req);
+    if (out) *out = req;
+    return handler_called;
+}
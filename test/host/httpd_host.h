@@ -0,0 +1,31 @@
+// Host fake of the parts of esp_http_server, esp_timer and getpeername() that web_admission.c uses.
+// Time is simulated: set host_now_us before dispatching a request.
+#pragma once
+#include "esp_http_server.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct {
+    const char *uri;
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+} host_uri_t;
+
+extern int64_t host_now_us;
+
+/**
+ * @brief Returns the handler registered for the URI, or NULL.
+ */
+const host_uri_t *host_find(const char *uri);
+
+/**
+ * @brief Dispatches a request of client n (peer 192.168.4.(n + 2)) like httpd does.
+ * Returns true if the wrapped handler ran; the response status and Retry-After are left in *out if given.
+ */
+bool host_dispatch(const host_uri_t *r, int client, httpd_req_t *out);
+
+/**
+ * @brief Handler that only records that it ran and with which user_ctx.
+ */
+esp_err_t host_handler(httpd_req_t *req);
+extern void *host_handler_ctx;
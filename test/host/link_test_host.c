@@ -0,0 +1,63 @@
+/*
+ * Host driver of main/link_test.c: runs one link test over BSD sockets and prints the result
+ * as JSON, so every mode can be checked over loopback against tools/link_test.py.
+ *
+ * Usage: link_test_host <tcp_rx|tcp_tx|udp_rx|udp_tx|echo> [--host 127.0.0.1] [--port 5001]
+ *            [--duration 10] [--rate 1000] [--len 1470]
+ *
+ * SIGINT/SIGTERM stop the run via link_test_stop().
+ */
+#include "link_test.h"
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void on_signal(int sig) {
+    (void)sig;
+    link_test_stop();
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s <tcp_rx|tcp_tx|udp_rx|udp_tx|echo> [--host ip] [--port n] "
+                    "[--duration s] [--rate kbps] [--len bytes]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) usage(argv[0]);
+
+    link_test_config_t cfg = { .port = 5001, .duration_ms = 10000, .rate_kbps = 1000, .len = 1470 };
+    strcpy(cfg.host, "127.0.0.1");
+    cfg.mode = link_test_mode_from_name(argv[1]);
+    if (cfg.mode == LINK_TEST_MODE_COUNT) usage(argv[0]);
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        const char *key = argv[i], *val = argv[i + 1];
+        if (strcmp(key, "--host") == 0) {
+            snprintf(cfg.host, sizeof(cfg.host), "%s", val);
+        } else if (strcmp(key, "--port") == 0) {
+            cfg.port = (uint16_t)strtoul(val, NULL, 10);
+        } else if (strcmp(key, "--duration") == 0) {
+            cfg.duration_ms = (uint32_t)(strtod(val, NULL) * 1000);
+        } else if (strcmp(key, "--rate") == 0) {
+            cfg.rate_kbps = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(key, "--len") == 0) {
+            cfg.len = (uint16_t)strtoul(val, NULL, 10);
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    link_test_result_t res;
+    link_test_run(&cfg, &res);
+    printf("{\"mode\":\"%s\",\"error\":%d,\"bytes\":%llu,\"elapsed_ms\":%lu,\"yield_ms\":%lu,"
+           "\"throughput_kbps\":%lu,\"packets\":%lu,\"lost\":%lu,\"out_of_order\":%lu,\"jitter_us\":%lu}\n",
+           link_test_mode_name(res.mode), res.error, (unsigned long long)res.bytes, (unsigned long)res.elapsed_ms,
+           (unsigned long)res.yield_ms, (unsigned long)res.throughput_kbps, (unsigned long)res.packets,
+           (unsigned long)res.lost, (unsigned long)res.out_of_order, (unsigned long)res.jitter_us);
+    return res.error ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+#!/usr/bin/env bash
+# Runs every link test mode of main/link_test.c over loopback against tools/link_test.py and
+# checks the reported bytes, packets and loss of both sides.
+#
+# Usage: test/host/run_link_test.sh [path/to/link_test_host]
+set -euo pipefail
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+DEV="${1:-$HERE/build/link_test_host}"
+PEER="$HERE/../../tools/link_test.py"
+PORT=5301
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+# run <name> <device-first|host-first> <device args> -- <host args>
+run() {
+    local name="$1" order="$2"; shift 2
+    local dev_args=() host_args=()
+    while [[ "$1" != "--" ]]; do dev_args+=("$1"); shift; done
+    shift
+    host_args=("$@")
+    PORT=$((PORT + 1))
+    local t0
+    t0=$(date +%s%N)
+
+    if [[ "$order" == device-first ]]; then
+        "$DEV" "${dev_args[@]}" --port "$PORT" > "$WORK/dev.json" &
+        local pid=$!
+        sleep 0.3
+        python3 "$PEER" "${host_args[@]}" --host 127.0.0.1 --port "$PORT" > "$WORK/host.out"
+    else
+        python3 "$PEER" "${host_args[@]}" --host 127.0.0.1 --port "$PORT" > "$WORK/host.out" &
+        local pid=$!
+        sleep 0.3
+        "$DEV" "${dev_args[@]}" --port "$PORT" > "$WORK/dev.json"
+    fi
+    wait "$pid"
+    echo "$(( ($(date +%s%N) - t0) / 1000000 ))" > "$WORK/ms"
+    sed -n 's/^host: *//p' "$WORK/host.out" > "$WORK/host.json"
+    echo "$name"
+    echo "  device: $(cat "$WORK/dev.json")"
+    echo "  host:   $(cat "$WORK/host.json")"
+}
+
+# check <python expression over dev, host and secs (wall time of the run)>
+check() {
+    if python3 -c 'import json, sys
+dev = json.load(open(sys.argv[1])); host = json.load(open(sys.argv[2])); secs = int(open(sys.argv[3]).read()) / 1000
+sys.exit(0 if eval(sys.argv[4]) else 1)' "$WORK/dev.json" "$WORK/host.json" "$WORK/ms" "$1"; then
+        echo "  ok:     $1"
+    else
+        echo "  FAILED: $1"
+        FAILED=1
+    fi
+}
+
+# Sinks run longer than the peer so they end on the peer's EOF / FIN datagrams with all data
+run tcp_rx device-first tcp_rx --duration 4 -- tcp-send --duration 2
+check 'dev["error"] == 0 and dev["bytes"] > 0 and dev["bytes"] == host["bytes"]'
+
+run tcp_tx host-first tcp_tx --duration 2 -- tcp-recv --duration 2
+check 'dev["error"] == 0 and dev["bytes"] > 0 and dev["bytes"] == host["bytes"]'
+
+run udp_rx device-first udp_rx --duration 4 -- udp-send --duration 2 --rate 5000 --len 1470
+check 'dev["error"] == 0 and dev["packets"] > 0 and dev["packets"] == host["packets"] and dev["lost"] == 0'
+check 'dev["bytes"] == dev["packets"] * 1470'
+
+run udp_tx host-first udp_tx --duration 2 --rate 5000 --len 1470 -- udp-recv --duration 2
+check 'dev["error"] == 0 and dev["packets"] > 0 and host["packets"] == dev["packets"] and host["lost"] == 0'
+check 'abs(dev["throughput_kbps"] - 5000) < 500'
+
+# Unpaced source: must keep running (and yielding) until the deadline; loopback may drop datagrams
+run udp_tx_unpaced host-first udp_tx --duration 2 --rate 0 --len 1470 -- udp-recv --duration 2
+check 'dev["error"] == 0 and dev["packets"] > 0 and host["packets"] > 0 and dev["elapsed_ms"] >= 1900'
+
+# Nothing sent: the end marker must still be negative so the peer does not wait for its timeout
+run udp_tx_empty host-first udp_tx --duration 0 -- udp-recv --duration 2
+check 'dev["error"] == 0 and dev["packets"] == 0 and host["packets"] == 0 and secs < 3'
+
+run echo device-first echo --duration 3 -- echo --duration 2 --len 64 --interval 0.01
+check 'dev["error"] == 0 and host["sent"] > 0 and host["lost"] == 0 and dev["packets"] == host["sent"]'
+
+# Loss accounting: datagrams 0-2 lost before the first one received, 4 duplicated
+PORT=$((PORT + 1))
+"$DEV" udp_rx --port "$PORT" --duration 3 > "$WORK/dev.json" &
+pid=$!
+sleep 0.3
+python3 -c 'import socket, struct, sys
+s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+for seq in (3, 4, 4, 5, -6):
+    s.sendto(struct.pack("!iII", seq, 0, 0) + bytes(100), ("127.0.0.1", int(sys.argv[1])))' "$PORT"
+wait "$pid"
+echo '{}' > "$WORK/host.json"
+echo "udp_rx_sequence"
+echo "  device: $(cat "$WORK/dev.json")"
+check 'dev["packets"] == 4 and dev["lost"] == 3 and dev["out_of_order"] == 0'
+
+# A peer that connects and never sends must not hold the sink past its duration
+PORT=$((PORT + 1))
+t0=$(date +%s%N)
+"$DEV" tcp_rx --port "$PORT" --duration 2 > "$WORK/dev.json" &
+pid=$!
+sleep 0.3
+python3 -c 'import socket, sys, time
+s = socket.create_connection(("127.0.0.1", int(sys.argv[1])))
+time.sleep(10)' "$PORT" &
+idle=$!
+wait "$pid"
+echo "$(( ($(date +%s%N) - t0) / 1000000 ))" > "$WORK/ms"
+kill "$idle" 2> /dev/null || true
+echo "tcp_rx_idle_peer"
+echo "  device: $(cat "$WORK/dev.json")"
+check 'dev["error"] == 0 and dev["bytes"] == 0 and secs < 3'
+
+# A stop request ends a long sink early
+"$DEV" udp_rx --port $((PORT + 1)) --duration 30 > "$WORK/dev.json" &
+pid=$!
+sleep 0.3
+kill -INT "$pid"
+start=$SECONDS
+wait "$pid" || true
+echo "stop"
+echo "  device: $(cat "$WORK/dev.json")"
+if (( SECONDS - start <= 1 )) && grep -q '"error":0' "$WORK/dev.json"; then echo "  ok:     stopped within the poll interval"; else echo "  FAILED: stop"; FAILED=1; fi
+
+exit "$FAILED"
@@ -0,0 +1,9 @@
+// Host stub of the ESP-IDF header, only what the host builds use
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef int esp_err_t;
+#define ESP_OK          0
+#define ESP_FAIL        -1
+#define ESP_ERR_NO_MEM  0x101
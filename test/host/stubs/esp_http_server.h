@@ -0,0 +1,32 @@
+// Host stub of the ESP-IDF header, only what the host builds use
+#pragma once
+#include <stddef.h>
+#include "esp_err.h"
+
+#define HTTP_GET  1
+#define HTTP_POST 3
+#define HTTPD_RESP_USE_STRLEN -1
+
+typedef void *httpd_handle_t;
+
+typedef struct httpd_req {
+    const char *uri;
+    void *user_ctx;
+    size_t content_len;
+    int sockfd;             // Host only: socket reported by httpd_req_to_sockfd
+    int status;             // Host only: status set by the handler (200 unless changed)
+    char retry_after[12];   // Host only: Retry-After header set by the handler
+} httpd_req_t;
+
+typedef struct {
+    const char *uri;
+    int method;
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+} httpd_uri_t;
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri);
+int httpd_req_to_sockfd(httpd_req_t *req);
+esp_err_t httpd_resp_set_status(httpd_req_t *req, const char *status);
+esp_err_t httpd_resp_set_hdr(httpd_req_t *req, const char *field, const char *value);
+esp_err_t httpd_resp_send(httpd_req_t *req, const char *buf, long len);
@@ -0,0 +1,6 @@
+// Host stub of the ESP-IDF header, logging is compiled out
+#pragma once
+#define ESP_LOGE(tag, ...) ((void)(tag))
+#define ESP_LOGW(tag, ...) ((void)(tag))
+#define ESP_LOGI(tag, ...) ((void)(tag))
+#define ESP_LOGD(tag, ...) ((void)(tag))
@@ -0,0 +1,5 @@
+// Host stub of the ESP-IDF header, the time source is provided by the host program
+#pragma once
+#include <stdint.h>
+
+int64_t esp_timer_get_time(void);
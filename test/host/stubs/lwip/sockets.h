@@ -0,0 +1,7 @@
+// Host stub of the lwIP header: POSIX sockets, peer address provided by the host program
+#pragma once
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define getpeername host_getpeername
+int host_getpeername(int sockfd, struct sockaddr *addr, socklen_t *addrlen);
@@ -0,0 +1,18 @@
+// Host stub of the generated sdkconfig.h with the defaults of the project sdkconfig
+#pragma once
+
+#ifndef CONFIG_WIFI_MANAGER_RATE_LIMIT
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT 1
+#endif
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_MAX_CLIENTS 8
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_BURST 5
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_REFILL_MS 1000
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_BURST 2
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_REFILL_MS 10000
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_CLIENT_REFILL_MS 30000
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_BURST 2
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_REFILL_MS 30000
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_CLIENT_REFILL_MS 60000
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_DIAG_BURST 3
+#define CONFIG_WIFI_MANAGER_RATE_LIMIT_DIAG_REFILL_MS 5000
+#define CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS 8
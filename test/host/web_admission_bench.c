@@ -0,0 +1,154 @@
+/*
+ * Host benchmark of main/web_admission.c.
+ *
+ * 1. Overhead: wall-clock cost of the admission wrapper per request.
+ * 2. Starvation/fairness: discrete-event simulation of the single httpd task. Several clients
+ *    hammer /wifi_scan (each admitted scan blocks the task for SCAN_MS), one client polls
+ *    /wifi_status like the web UI. Reports how long the status poller waits and how the
+ *    admitted scans are split between the clients.
+ * 3. Config fairness: one client retries POST /wifi back to back, a second one tries every few
+ *    seconds. Reports how the admitted requests (each a WiFi teardown) are split.
+ *
+ * Built twice by the Makefile, with CONFIG_WIFI_MANAGER_RATE_LIMIT=1 and =0.
+ */
+#include "web_admission.h"
+#include "httpd_host.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_DURATION_MS     (10 * 60 * 1000)
+#define SCAN_MS             2500    // Blocking esp_wifi_scan_start()
+#define STATUS_MS           2
+#define REJECT_US           200     // 429 fast path
+#define THINK_MS            10      // Scanner pause between requests
+#define STATUS_POLL_MS      3000    // Web UI status interval
+#define SCANNERS            4
+#define MAX_SAMPLES         4096
+#define CONFIG_MS           3000    // POST /wifi blocks for the credential test
+#define CONFIG_RETRY_MS     5000    // Second client's retry interval
+
+/**
+ * @brief Dispatches a request; returns true if the wrapped handler ran.
+ */
+static bool dispatch(const host_uri_t *r, int client) {
+    return host_dispatch(r, client, NULL);
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t*)a, y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_overhead(void) {
+    const host_uri_t *status = host_find("/wifi_status");
+    const int iterations = 2000000;
+    int admitted = 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int i = 0; i < iterations; i++) {
+        host_now_us += 500;
+        admitted += dispatch(status, i % 16);    // 16 clients > table size, exercises LRU eviction
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double ns = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / iterations;
+    printf("overhead: %.1f ns/request (%d of %d admitted)\n", ns, admitted, iterations);
+}
+
+static void bench_starvation(void) {
+    const host_uri_t *scan = host_find("/wifi_scan");
+    const host_uri_t *status = host_find("/wifi_status");
+    int64_t next[SCANNERS + 1] = {0};
+    int scans[SCANNERS] = {0};
+    int rejected = 0;
+    int64_t waits[MAX_SAMPLES];
+    int samples = 0;
+    int64_t server_free = 0, radio_busy = 0;
+
+    host_now_us = 0;
+    while (1) {
+        int c = 0;
+        for (int i = 1; i <= SCANNERS; i++) {
+            if (next[i] < next[c]) c = i;
+        }
+        int64_t arrival = next[c];
+        if (arrival >= (int64_t)SIM_DURATION_MS * 1000) break;
+
+        int64_t start = arrival > server_free ? arrival : server_free;
+        host_now_us = start;
+        int64_t service;
+        if (c == SCANNERS) {
+            service = dispatch(status, c) ? STATUS_MS * 1000 : REJECT_US;
+        } else if (dispatch(scan, c)) {
+            service = SCAN_MS * 1000;
+            radio_busy += service;
+            scans[c]++;
+        } else {
+            service = REJECT_US;
+            rejected++;
+        }
+        int64_t end = start + service;
+        server_free = end;
+
+        if (c == SCANNERS) {
+            if (samples < MAX_SAMPLES) waits[samples++] = end - arrival;
+            next[c] = arrival + STATUS_POLL_MS * 1000 > end ? arrival + STATUS_POLL_MS * 1000 : end;
+        } else {
+            next[c] = end + THINK_MS * 1000;
+        }
+    }
+
+    qsort(waits, samples, sizeof(waits[0]), cmp_i64);
+    printf("starvation: %d scanners for %d s, httpd blocked by scans %.1f%% of the time\n",
+           SCANNERS, SIM_DURATION_MS / 1000, 100.0 * radio_busy / server_free);
+    printf("  /wifi_status latency: p50 %lld ms, p99 %lld ms, max %lld ms (%d polls)\n",
+           (long long)waits[samples / 2] / 1000, (long long)waits[samples * 99 / 100] / 1000,
+           (long long)waits[samples - 1] / 1000, samples);
+    printf("  /wifi_scan admitted per client:");
+    for (int i = 0; i < SCANNERS; i++) printf(" %d", scans[i]);
+    printf(" (%d rejected with 429)\n", rejected);
+}
+
+static void bench_config(void) {
+    const host_uri_t *config = host_find("/wifi");
+    int64_t start_us = (int64_t)SIM_DURATION_MS * 1000 * 2;    // After the other runs, buckets are full again
+    int64_t end_us = start_us + (int64_t)SIM_DURATION_MS * 1000;
+    int64_t next[2] = { start_us, start_us };
+    int admitted[2] = {0};
+    int64_t server_free = start_us;
+
+    while (1) {
+        int c = next[1] < next[0];
+        int64_t arrival = next[c];
+        if (arrival >= end_us) break;
+
+        int64_t start = arrival > server_free ? arrival : server_free;
+        host_now_us = start;
+        bool ok = dispatch(config, 100 + c);
+        admitted[c] += ok;
+        server_free = start + (ok ? CONFIG_MS * 1000 : REJECT_US);
+        next[c] = c == 0 ? server_free + THINK_MS * 1000 : arrival + CONFIG_RETRY_MS * 1000;
+    }
+    printf("config: 1 client retrying back to back, 1 every %d s, for %d s\n", CONFIG_RETRY_MS / 1000, SIM_DURATION_MS / 1000);
+    printf("  POST /wifi admitted (WiFi teardowns): hammering %d, other %d\n", admitted[0], admitted[1]);
+}
+
+int main(void) {
+    printf("CONFIG_WIFI_MANAGER_RATE_LIMIT=%s\n", CONFIG_WIFI_MANAGER_RATE_LIMIT ? "y" : "n");
+
+    httpd_uri_t status = { .uri = "/wifi_status", .method = HTTP_GET, .handler = host_handler, .user_ctx = NULL };
+    web_admission_register_uri_handler(NULL, &status, WEB_ADMISSION_STATUS);
+    httpd_uri_t scan = { .uri = "/wifi_scan", .method = HTTP_GET, .handler = host_handler, .user_ctx = NULL };
+    web_admission_register_uri_handler(NULL, &scan, WEB_ADMISSION_SCAN);
+    httpd_uri_t config = { .uri = "/wifi", .method = HTTP_POST, .handler = host_handler, .user_ctx = NULL };
+    web_admission_register_uri_handler(NULL, &config, WEB_ADMISSION_CONFIG);
+
+    bench_starvation();
+    bench_config();
+    bench_overhead();
+    return 0;
+}
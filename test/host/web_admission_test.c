@@ -0,0 +1,129 @@
+/*
+ * Pass/fail checks of main/web_admission.c with the defaults of the project sdkconfig:
+ * burst and refill, Retry-After, that a rejecting bucket leaves the other one uncharged,
+ * LRU eviction of the client table, config fairness and the endpoint table limit.
+ */
+#include "web_admission.h"
+#include "httpd_host.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <string.h>
+
+#define SEC(s)  ((int64_t)(s) * 1000000)
+
+static int failed = 0;
+
+#define CHECK(cond) do { \
+        if (cond) { printf("  ok:     %s\n", #cond); } \
+        else { printf("  FAILED: %s (line %d)\n", #cond, __LINE__); failed = 1; } \
+    } while (0)
+
+static const host_uri_t *status, *scan, *config;
+static int status_ctx;
+
+/**
+ * @brief Sends one request at time t; returns the HTTP status.
+ */
+static int request(const host_uri_t *r, int client, int64_t t, httpd_req_t *out) {
+    httpd_req_t req;
+    host_now_us = t;
+    host_dispatch(r, client, &req);
+    if (out) *out = req;
+    return req.status;
+}
+
+static void test_status_burst_and_refill(void) {
+    httpd_req_t req;
+    printf("status burst and refill\n");
+    int admitted = 0;
+    for (int i = 0; i < CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_BURST + 3; i++) {
+        admitted += request(status, 0, SEC(100), NULL) == 200;
+    }
+    CHECK(admitted == CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_BURST);
+    CHECK(request(status, 0, SEC(100), &req) == 429 && strcmp(req.retry_after, "1") == 0);
+    CHECK(request(status, 1, SEC(100), NULL) == 200);     // Other clients have their own bucket
+    CHECK(request(status, 0, SEC(100) + CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_REFILL_MS * 1000 - 1, NULL) == 429);
+    CHECK(request(status, 0, SEC(100) + CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_REFILL_MS * 1000, NULL) == 200);
+    CHECK(request(status, 0, SEC(100) + CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_REFILL_MS * 1000, NULL) == 429);
+    CHECK(host_handler_ctx == &status_ctx);             // Wrapped handler gets its own user_ctx
+}
+
+static void test_scan_buckets(void) {
+    httpd_req_t req;
+    const int64_t t0 = SEC(1000);
+    const int64_t refill = CONFIG_WIFI_MANAGER_RATE_LIMIT_SCAN_REFILL_MS * 1000;
+    printf("scan: client and global bucket\n");
+    CHECK(request(scan, 10, t0, NULL) == 200);            // Global 2 -> 1
+    // Rejected by its own bucket: the global token must stay for the next client
+    CHECK(request(scan, 10, t0, &req) == 429 && strcmp(req.retry_after, "30") == 0);
+    CHECK(request(scan, 11, t0, NULL) == 200);            // Global 1 -> 0
+    // Rejected by the global bucket: the client bucket must stay full
+    CHECK(request(scan, 12, t0, &req) == 429 && strcmp(req.retry_after, "10") == 0);
+    CHECK(request(scan, 12, t0 + refill, NULL) == 200);
+    CHECK(request(scan, 13, t0 + refill, NULL) == 429);
+    // Both buckets empty: Retry-After is the longer wait
+    CHECK(request(scan, 10, t0 + refill, &req) == 429 && strcmp(req.retry_after, "20") == 0);
+}
+
+static void test_lru_eviction(void) {
+    const int64_t t0 = SEC(2000);
+    const int n = CONFIG_WIFI_MANAGER_RATE_LIMIT_MAX_CLIENTS;
+    printf("client table LRU eviction\n");
+    // Fill the table with drained clients, oldest first
+    for (int c = 0; c < n; c++) {
+        for (int i = 0; i < CONFIG_WIFI_MANAGER_RATE_LIMIT_STATUS_BURST; i++) {
+            request(status, 20 + c, t0 + c, NULL);
+        }
+    }
+    CHECK(request(status, 20 + n - 1, t0 + n, NULL) == 429);
+    CHECK(request(status, 20 + n, t0 + n, NULL) == 200);          // New client evicts client 20
+    CHECK(request(status, 20 + n - 1, t0 + n, NULL) == 429);      // Still tracked
+    CHECK(request(status, 20, t0 + n, NULL) == 200);              // Evicted: starts with a full bucket
+}
+
+static void test_config_fairness(void) {
+    const int64_t t0 = SEC(10000);
+    const int64_t duration = SEC(600);
+    int admitted[2] = {0};
+    printf("config: hammering client cannot starve another\n");
+    // Client 40 retries every 10 ms, client 41 every 5 s
+    for (int64_t t = t0; t < t0 + duration; t += 10000) {
+        admitted[0] += request(config, 40, t, NULL) == 200;
+        if ((t - t0) % SEC(5) == 0) admitted[1] += request(config, 41, t, NULL) == 200;
+    }
+    int64_t global = CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_BURST + duration / 1000 / CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_REFILL_MS;
+    int64_t per_client = 1 + duration / 1000 / CONFIG_WIFI_MANAGER_RATE_LIMIT_CONFIG_CLIENT_REFILL_MS;
+    printf("  admitted: hammering %d, other %d (global budget %lld)\n", admitted[0], admitted[1], (long long)global);
+    CHECK(admitted[0] <= per_client);
+    CHECK(admitted[1] >= global - per_client - 1);
+    CHECK(admitted[0] + admitted[1] <= global);
+}
+
+static void test_endpoint_table(void) {
+    printf("endpoint table\n");
+    httpd_uri_t extra = { .uri = "/extra", .method = HTTP_GET, .handler = host_handler, .user_ctx = NULL };
+    esp_err_t last = ESP_OK;
+    for (int i = 0; i < CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS && last == ESP_OK; i++) {
+        last = web_admission_register_uri_handler(NULL, &extra, WEB_ADMISSION_STATUS);
+    }
+    CHECK(last == ESP_ERR_NO_MEM);
+}
+
+int main(void) {
+    httpd_uri_t uri_status = { .uri = "/wifi_status", .method = HTTP_GET, .handler = host_handler, .user_ctx = &status_ctx };
+    httpd_uri_t uri_scan = { .uri = "/wifi_scan", .method = HTTP_GET, .handler = host_handler, .user_ctx = NULL };
+    httpd_uri_t uri_config = { .uri = "/wifi", .method = HTTP_POST, .handler = host_handler, .user_ctx = NULL };
+    web_admission_register_uri_handler(NULL, &uri_status, WEB_ADMISSION_STATUS);
+    web_admission_register_uri_handler(NULL, &uri_scan, WEB_ADMISSION_SCAN);
+    web_admission_register_uri_handler(NULL, &uri_config, WEB_ADMISSION_CONFIG);
+    status = host_find("/wifi_status");
+    scan = host_find("/wifi_scan");
+    config = host_find("/wifi");
+
+    test_status_burst_and_refill();
+    test_scan_buckets();
+    test_lru_eviction();
+    test_config_fairness();
+    test_endpoint_table();
+    return failed;
+}
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""Host-side load generator for the WiFi Manager HTTP API.
+
+Runs N concurrent clients against one or more endpoints for a fixed duration and
+reports per client and endpoint the number of admitted (2xx) and rejected (429)
+requests and their latency percentiles.
+
+The device keys its buckets by peer IP, so clients sharing one address share one
+budget. To measure fairness give each client its own address with --source
+(addresses must be configured on the host interface, e.g. as secondary IPs);
+clients are assigned to the source addresses round-robin.
+
+Usage: tools/http_load.py [--host 192.168.4.1] [--clients 4] [--duration 30] \
+           [--source 192.168.4.10 --source 192.168.4.11 ...] \
+           [--path /wifi_status] [--path /wifi_scan]
+
+Do not pass POST /wifi_reset: an admitted request erases the credentials and reboots the device.
+"""
+
+import argparse
+import http.client
+import threading
+import time
+from collections import defaultdict
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100))]
+
+
+def client(name, source, host, port, requests, deadline, results, lock):
+    while time.monotonic() < deadline:
+        for method, path in requests:
+            start = time.monotonic()
+            try:
+                conn = http.client.HTTPConnection(host, port, timeout=15,
+                                                  source_address=(source, 0) if source else None)
+                conn.request(method, path, body=b"" if method == "POST" else None)
+                status = conn.getresponse().status
+                conn.close()
+            except OSError:
+                status = "error"
+            elapsed_ms = (time.monotonic() - start) * 1000
+            with lock:
+                results[(name, method, path)][status].append(elapsed_ms)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4)
+    parser.add_argument("--source", action="append", default=[], help="local source address (repeatable)")
+    parser.add_argument("--duration", type=float, default=30)
+    parser.add_argument("--path", action="append", default=[], help="GET endpoint (repeatable)")
+    parser.add_argument("--post", action="append", default=[], help="POST endpoint (repeatable)")
+    args = parser.parse_args()
+
+    requests = [("GET", p) for p in args.path] + [("POST", p) for p in args.post]
+    if not requests:
+        requests = [("GET", "/wifi_status"), ("GET", "/wifi_scan")]
+
+    results = defaultdict(lambda: defaultdict(list))
+    lock = threading.Lock()
+    deadline = time.monotonic() + args.duration
+    threads = []
+    for i in range(args.clients):
+        source = args.source[i % len(args.source)] if args.source else None
+        name = "%d@%s" % (i, source or "default")
+        threads.append(threading.Thread(target=client,
+                                        args=(name, source, args.host, args.port, requests, deadline, results, lock)))
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    print("%-20s %-6s %-14s %-6s %8s %8s %10s %10s" % (
+        "CLIENT", "METHOD", "PATH", "STATUS", "COUNT", "REQ/S", "P50 ms", "P99 ms"))
+    for (name, method, path), by_status in sorted(results.items()):
+        for status, latencies in sorted(by_status.items(), key=lambda kv: str(kv[0])):
+            print("%-20s %-6s %-14s %-6s %8d %8.1f %10.1f %10.1f" % (
+                name, method, path, status, len(latencies), len(latencies) / args.duration,
+                percentile(latencies, 50), percentile(latencies, 99)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Host-side peer for the WiFi Manager link self-test (/link_test).
+
+Runs the counterpart of a device test mode. With --device the matching device mode
+is started over HTTP first and its result (throughput, jitter, loss, RSSI, channel)
+is printed when the run is finished.
+
+  device mode   host command
+  tcp_rx        tcp-send  (host sends TCP to the device)
+  tcp_tx        tcp-recv  (host receives TCP from the device)
+  udp_rx        udp-send  (host sends iperf2-style datagrams at --rate)
+  udp_tx        udp-recv  (host receives iperf2-style datagrams)
+  echo          echo      (host measures UDP round-trip latency)
+
+Usage: tools/link_test.py echo --host 192.168.4.1 [--device 192.168.4.1] [--duration 10]
+"""
+
+import argparse
+import json
+import socket
+import struct
+import time
+import urllib.parse
+import urllib.request
+
+DEVICE_MODES = {"tcp-send": "tcp_rx", "tcp-recv": "tcp_tx", "udp-send": "udp_rx", "udp-recv": "udp_tx", "echo": "echo"}
+HDR = struct.Struct("!iII")     # iperf2 datagram header: id, sec, usec
+
+
+def local_ip_towards(host):
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.connect((host, 9))
+        return s.getsockname()[0]
+
+
+def start_device(args):
+    form = {"mode": DEVICE_MODES[args.command], "port": args.port, "duration": int(args.duration),
+            "rate": args.rate, "len": args.len}
+    if args.command in ("tcp-recv", "udp-recv"):
+        form["host"] = local_ip_towards(args.device)
+    data = urllib.parse.urlencode(form).encode()
+    urllib.request.urlopen("http://%s/link_test" % args.device, data=data, timeout=10).read()
+    time.sleep(0.5)     # Give the device time to bind
+
+
+def device_result(args):
+    while True:
+        with urllib.request.urlopen("http://%s/link_test" % args.device, timeout=10) as r:
+            res = json.load(r)
+        if not res["running"]:
+            return res
+        time.sleep(1)
+
+
+def tcp_send(args):
+    buf = bytes(range(256)) * 16
+    sent = 0
+    with socket.create_connection((args.host, args.port), timeout=10) as s:
+        start = time.monotonic()
+        while time.monotonic() - start < args.duration:
+            sent += s.send(buf)
+    return {"bytes": sent, "kbps": sent * 8 / 1000 / args.duration}
+
+
+def tcp_recv(args):
+    with socket.create_server(("", args.port)) as srv:
+        srv.settimeout(args.duration + 10)
+        conn, _ = srv.accept()
+        with conn:
+            received, start = 0, time.monotonic()
+            while True:
+                data = conn.recv(65536)
+                if not data:
+                    break
+                received += len(data)
+            elapsed = time.monotonic() - start
+    return {"bytes": received, "kbps": received * 8 / 1000 / elapsed}
+
+
+def udp_send(args):
+    payload = bytes(max(args.len - HDR.size, 0))
+    interval = args.len * 8 / (args.rate * 1000) if args.rate else 0
+    seq = 0
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.connect((args.host, args.port))
+        start = next_t = time.monotonic()
+        while time.monotonic() - start < args.duration:
+            now = time.time()
+            s.send(HDR.pack(seq, int(now), int(now % 1 * 1e6)) + payload)
+            seq += 1
+            next_t += interval
+            delay = next_t - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+        for _ in range(10):
+            try:
+                s.send(HDR.pack(-seq if seq else -1, 0, 0) + payload)     # End marker must be negative
+            except ConnectionRefusedError:
+                break   # Device closed its socket on the first end-of-test datagram
+    return {"packets": seq, "kbps": seq * args.len * 8 / 1000 / args.duration}
+
+
+def udp_recv(args):
+    packets, received, highest, lost = 0, 0, -1, 0
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.bind(("", args.port))
+        s.settimeout(args.duration + 10)
+        start = last = None
+        while True:
+            try:
+                data = s.recv(65536)
+            except socket.timeout:
+                if start is None:
+                    raise
+                break   # End markers lost (e.g. receive buffer overrun by an unpaced source)
+            seq = HDR.unpack_from(data)[0]
+            if seq < 0:
+                break
+            if start is None:
+                start = time.monotonic()
+                s.settimeout(2)
+            last = time.monotonic()
+            packets, received = packets + 1, received + len(data)
+            if seq > highest:
+                lost += seq - highest - 1   # Sequence numbers start at 0
+                highest = seq
+        elapsed = (last - start if start else 0) or 1
+    return {"packets": packets, "lost": lost, "kbps": received * 8 / 1000 / elapsed}
+
+
+def echo(args):
+    rtts, sent = [], 0
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as s:
+        s.connect((args.host, args.port))
+        s.settimeout(1)
+        start = time.monotonic()
+        while time.monotonic() - start < args.duration:
+            probe = struct.pack("!I", sent) + bytes(max(args.len - 4, 0))
+            t0 = time.perf_counter()
+            s.send(probe)
+            sent += 1
+            try:
+                while s.recv(65536)[:4] != probe[:4]:
+                    pass
+                rtts.append((time.perf_counter() - t0) * 1000)
+            except socket.timeout:
+                pass
+            time.sleep(args.interval)
+    rtts.sort()
+    pick = lambda p: rtts[min(len(rtts) - 1, int(len(rtts) * p / 100))] if rtts else 0
+    return {"sent": sent, "lost": sent - len(rtts), "rtt_min_ms": rtts[0] if rtts else 0,
+            "rtt_p50_ms": pick(50), "rtt_p99_ms": pick(99), "rtt_max_ms": rtts[-1] if rtts else 0}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("command", choices=sorted(DEVICE_MODES))
+    parser.add_argument("--host", default="192.168.4.1", help="device address for tcp-send, udp-send and echo")
+    parser.add_argument("--device", help="start the matching device mode over HTTP at this address")
+    parser.add_argument("--port", type=int, default=5001)
+    parser.add_argument("--duration", type=float, default=10)
+    parser.add_argument("--rate", type=int, default=1000, help="UDP rate in kbit/s")
+    parser.add_argument("--len", type=int, default=1470, help="UDP datagram / echo probe length")
+    parser.add_argument("--interval", type=float, default=0.05, help="echo probe interval in seconds")
+    args = parser.parse_args()
+
+    if args.device:
+        start_device(args)
+    result = globals()[args.command.replace("-", "_")](args)
+    print("host:  ", json.dumps(result))
+    if args.device:
+        print("device:", json.dumps(device_result(args)))
+
+
+if __name__ == "__main__":
+    main()
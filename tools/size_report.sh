@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+# Builds every combination of the WiFi Manager feature switches and prints
+# flash and static RAM usage per combination (from `idf.py size --format json2`).
+#
+# Every combination starts from sdkconfig.minimal; the URI handler count and the task stacks
+# are raised to what the enabled features need, so every row is a working build.
+#
+# Usage: tools/size_report.sh [target]   (default target: esp32c6)
+# Requires an exported ESP-IDF environment and python3.
+
+set -euo pipefail
+
+TARGET="${1:-esp32c6}"
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+OUT="${ROOT}/build_size"
+# Feature switches (CONFIG_WIFI_MANAGER_<name>) and their column labels
+FEATURES=(WEB_UI SCAN_ENDPOINT USE_CJSON AP_FALLBACK LINK_TEST STORE_PMK RATE_LIMIT)
+LABELS=(UI SCAN JSON AP LINK PMK RATE)
+
+FMT="$(printf '%%-4s %.0s' "${FEATURES[@]}")%10s %10s %10s\n"
+mkdir -p "${OUT}"
+printf "${FMT}" "${LABELS[@]}" FLASH DRAM IRAM
+
+for ((mask = 0; mask < (1 << ${#FEATURES[@]}); mask++)); do
+    name="size_${mask}"
+    fragment="${OUT}/${name}.defaults"
+    : > "${fragment}"
+    flags=()
+    for i in "${!FEATURES[@]}"; do
+        if (( mask & (1 << i) )); then
+            echo "CONFIG_WIFI_MANAGER_${FEATURES[$i]}=y" >> "${fragment}"
+            flags+=(y)
+        else
+            echo "CONFIG_WIFI_MANAGER_${FEATURES[$i]}=n" >> "${fragment}"
+            flags+=(-)
+        fi
+    done
+    # /wifi, /wifi_reset, /wifi_status + "/" + /wifi_scan + GET/POST /link_test
+    handlers=$(( 3 + (mask & 1) + (mask >> 1 & 1) + 2 * (mask >> 4 & 1) ))
+    echo "CONFIG_WIFI_MANAGER_HTTPD_MAX_URI_HANDLERS=${handlers}" >> "${fragment}"
+    # The minimal stacks only fit the minimal endpoint set; UI, scan, cJSON, AP and link test use the defaults
+    if (( mask & 0x1f )); then
+        echo "CONFIG_WIFI_MANAGER_TASK_STACK_SIZE=4096" >> "${fragment}"
+        echo "CONFIG_WIFI_MANAGER_HTTPD_STACK_SIZE=4096" >> "${fragment}"
+    fi
+
+    idf.py -C "${ROOT}" -B "${OUT}/${name}" \
+        -D SDKCONFIG="${OUT}/${name}.sdkconfig" \
+        -D SDKCONFIG_DEFAULTS="${ROOT}/sdkconfig.minimal;${fragment}" \
+        -D IDF_TARGET="${TARGET}" \
+        build > "${OUT}/${name}.log" 2>&1
+
+    idf.py -C "${ROOT}" -B "${OUT}/${name}" -D SDKCONFIG="${OUT}/${name}.sdkconfig" \
+        size --format json2 2> /dev/null | python3 -c '
+import json, sys
+d = json.load(sys.stdin)
+lay = {m["name"]: m for m in d["layout"]}
+used = lambda *n: sum(lay[k]["used"] for k in n if k in lay)
+print("%10d %10d %10d" % (d.get("image_size", d.get("total_size", 0)), used("DRAM", "DIRAM"), used("IRAM")))
+' | xargs printf "${FMT}" "${flags[@]}"
+done